@@ -0,0 +1,63 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include "Arduino.h"
+
+/*****************************************************************************/
+
+static uint64_t elapsed_us()
+{
+  static struct timespec origin;
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  if (origin.tv_sec == 0 && origin.tv_nsec == 0)
+    origin = ts;
+  return (uint64_t)(ts.tv_sec - origin.tv_sec) * 1000000
+    + (ts.tv_nsec - origin.tv_nsec) / 1000;
+}
+
+static void sleep_us(uint64_t us)
+{
+  struct timespec ts;
+  ts.tv_sec = us / 1000000;
+  ts.tv_nsec = (us % 1000000) * 1000;
+  while (nanosleep(&ts, &ts) < 0 && errno == EINTR)
+    ;
+}
+
+unsigned long millis()
+{
+  return (unsigned long)(elapsed_us() / 1000);
+}
+
+unsigned long micros()
+{
+  return (unsigned long)elapsed_us();
+}
+
+void delay(unsigned long ms)
+{
+  sleep_us((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  sleep_us(us);
+}
+
+void yield()
+{
+  sched_yield();
+}
@@ -0,0 +1,51 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+// Minimal Arduino core replacement, to build the EasyVR library on Linux
+// without changes. Put this directory before the library sources in the
+// include path and link Arduino.cpp with the application, for example:
+//
+//   g++ -Iextras/linux -Isrc app.cpp src/*.cpp extras/linux/*.cpp
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include "Stream.h"
+
+/*****************************************************************************/
+
+#define HIGH  1
+#define LOW   0
+
+#define PROGMEM
+#define F(s)  (s)
+#define pgm_read_byte(p)  (*(const uint8_t*)(p))
+#define pgm_read_word(p)  (*(const uint16_t*)(p))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+/** Gets the time in milliseconds since the program started. */
+unsigned long millis();
+/** Gets the time in microseconds since the program started. */
+unsigned long micros();
+/** Sleeps for the given number of milliseconds. */
+void delay(unsigned long ms);
+/** Sleeps for the given number of microseconds. */
+void delayMicroseconds(unsigned int us);
+/** Gives up the processor while busy waiting. */
+void yield();
@@ -0,0 +1,175 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+// requires C++20, skipped by older compilers
+#if defined(__cpp_impl_coroutine)
+
+#include <poll.h>
+#include "Arduino.h"
+#include "EasyVRCoroutine.h"
+
+/*****************************************************************************/
+
+bool EasyVROperation::await_suspend(std::coroutine_handle<> h)
+{
+  if (_busy)
+  {
+    fail(); // another operation is using the module
+    return false;
+  }
+  _busy = true;
+  _handle = h;
+  _time = millis();
+  start();
+  _loop._ops.push_back(this);
+  return true;
+}
+
+bool EasyVRLoop::runOnce(int timeout)
+{
+  bool done = false;
+  for (size_t i = 0; i < _ops.size(); )
+  {
+    EasyVROperation* op = _ops[i];
+    if (!op->poll())
+    {
+      ++i;
+      continue;
+    }
+    _ops[i] = _ops.back();
+    _ops.pop_back();
+    op->_busy = false;
+    op->_handle.resume(); // may add new operations
+    done = true;
+  }
+  if (done || _ops.empty())
+    return !_ops.empty();
+
+  std::vector<struct pollfd> fds(_ops.size());
+  for (size_t i = 0; i < _ops.size(); ++i)
+  {
+    fds[i].fd = _ops[i]->_t.fd();
+    fds[i].events = POLLIN;
+    fds[i].revents = 0;
+    if (_ops[i]->_t.sending())
+      timeout = 1; // the next byte is due within a millisecond
+  }
+  poll(fds.data(), fds.size(), timeout);
+  return true;
+}
+
+void EasyVRCoroutine::Recognize::start()
+{
+  if (_target >= EasyVR::WORD_TARGET)
+    _vr.recognizeWord(_target - EasyVR::WORD_TARGET);
+  else
+    _vr.recognizeCommand(_target);
+}
+
+bool EasyVRCoroutine::Recognize::poll()
+{
+  if (_vr.hasFinished())
+  {
+    EasyVRDispatcher::decode(_vr, _result);
+    return true;
+  }
+  if (!expired())
+    return false;
+  _vr.stop();
+  fail();
+  return true;
+}
+
+void EasyVRCoroutine::Recognize::fail()
+{
+  _result.event = EasyVRDispatcher::ON_TIMEOUT;
+  _result.set = -1;
+  _result.value = 0;
+  _result.time = millis();
+}
+
+void EasyVRCoroutine::PlayMessage::start()
+{
+  _vr.playMessageAsync(_index, _speed, _atten);
+}
+
+bool EasyVRCoroutine::PlayMessage::poll()
+{
+  if (_vr.hasFinished())
+  {
+    _ok = _vr.getError() < 0 && !_vr.isInvalid();
+    return true;
+  }
+  if (!expired())
+    return false;
+  _vr.stop();
+  fail();
+  return true;
+}
+
+void EasyVRCoroutine::ExportCommand::start()
+{
+  _progress = 0;
+  _status = 0;
+  _vr.exportCommandAsync(_group, _index);
+}
+
+bool EasyVRCoroutine::ExportCommand::poll()
+{
+  int16_t last = _progress;
+  _status = _vr.hasExportedCommand(_data, _progress);
+  if (_status != 0)
+    return true;
+  if (_progress != last)
+    _time = millis();
+  else if (millis() - _time > _vr.getReplyTimeout(_progress == 0 ?
+    EasyVR::TIMEOUT_STORAGE : EasyVR::TIMEOUT_DEFAULT))
+  {
+    _status = -1; // no reply
+    return true;
+  }
+  return false;
+}
+
+EasyVRCoroutine::Recognize EasyVRCoroutine::recognize(int8_t group)
+{
+  Recognize op(_loop, _vr, _t, _busy, _limit);
+  op._target = group;
+  return op;
+}
+
+EasyVRCoroutine::Recognize EasyVRCoroutine::recognizeWord(int8_t wordset)
+{
+  Recognize op(_loop, _vr, _t, _busy, _limit);
+  op._target = wordset + EasyVR::WORD_TARGET;
+  return op;
+}
+
+EasyVRCoroutine::PlayMessage EasyVRCoroutine::playMessage(int8_t index, int8_t speed, int8_t atten)
+{
+  PlayMessage op(_loop, _vr, _t, _busy, _limit);
+  op._index = index;
+  op._speed = speed;
+  op._atten = atten;
+  return op;
+}
+
+EasyVRCoroutine::ExportCommand EasyVRCoroutine::exportCommand(int8_t group, int8_t index, uint8_t* data)
+{
+  ExportCommand op(_loop, _vr, _t, _busy, 0); // times out on missing progress
+  op._group = group;
+  op._index = index;
+  op._data = data;
+  return op;
+}
+
+#endif // __cpp_impl_coroutine
@@ -0,0 +1,226 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <vector>
+#include "Arduino.h"
+#include "EasyVR.h"
+#include "EasyVRDispatcher.h"
+#include "EasyVRPosixTransport.h"
+
+/*****************************************************************************/
+
+class EasyVRLoop;
+
+// Requires C++20 (for example g++ -std=c++20).
+
+/**
+  A coroutine started by the caller and left running on an #EasyVRLoop
+  (it cannot be awaited and it is destroyed when it completes).
+*/
+struct EasyVRTask
+{
+  struct promise_type
+  {
+    EasyVRTask get_return_object() { return EasyVRTask(); }
+    std::suspend_never initial_suspend() noexcept { return std::suspend_never(); }
+    std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+/**
+  A long-running operation on an %EasyVR module, that suspends the awaiting
+  coroutine until the operation completes.
+*/
+class EasyVROperation
+{
+  friend class EasyVRLoop;
+  std::coroutine_handle<> _handle;
+
+protected:
+  EasyVRLoop& _loop;
+  EasyVR& _vr;
+  EasyVRPosixTransport& _t;
+  bool& _busy;            // an operation is pending on the module
+  uint32_t _limit;        // time limit (0 = none)
+  unsigned long _time;    // time of start or last progress
+
+  EasyVROperation(EasyVRLoop& loop, EasyVR& vr, EasyVRPosixTransport& t, bool& busy,
+    uint32_t limit) : _loop(loop), _vr(vr), _t(t), _busy(busy), _limit(limit), _time(0) {}
+  /** Sends the request to the module. */
+  virtual void start() = 0;
+  /** Checks for completion, without waiting. */
+  virtual bool poll() = 0;
+  /** Sets the result of an operation that failed without a reply. */
+  virtual void fail() = 0;
+  /** Tells if the time limit has expired. */
+  bool expired() const { return _limit != 0 && millis() - _time >= _limit; }
+
+public:
+  virtual ~EasyVROperation() {}
+  bool await_ready() { return false; }
+  bool await_suspend(std::coroutine_handle<> h);
+};
+
+/**
+  Runs coroutines that use any number of %EasyVR modules on a single thread.
+
+  Each suspended coroutine waits for one #EasyVROperation, and the loop
+  checks all of them in turn, sleeping in poll() on the descriptors of the
+  modules while nothing happens.
+*/
+class EasyVRLoop
+{
+  friend class EasyVROperation;
+  std::vector<EasyVROperation*> _ops;
+
+public:
+  /**
+    Checks pending operations once and resumes completed coroutines.
+    @param timeout is the maximum time in milliseconds to sleep if no
+    operation completes
+    @retval true if some operation is still pending
+  */
+  bool runOnce(int timeout = 10);
+  /**
+    Runs until all coroutines have completed.
+  */
+  void run() { while (runOnce()) {} }
+};
+
+/**
+  Awaitable versions of the long-running functions of an %EasyVR module,
+  to use in coroutines running on an #EasyVRLoop.
+
+  Only one operation at a time can be pending on a module: an operation
+  awaited while another one is in progress (for example by a different
+  coroutine) fails at once, without sending anything to the module.
+  Recognition and playback are interrupted if they do not complete within
+  a time limit (see #setTimeLimit()).
+*/
+class EasyVRCoroutine
+{
+  EasyVRLoop& _loop;
+  EasyVRPosixTransport& _t;
+  EasyVR _vr;
+  bool _busy;
+  uint32_t _limit;
+
+public:
+  enum
+  {
+    DEF_LIMIT = 35000, /**< Default time limit of recognition and playback (in ms) */
+  };
+
+  /** Awaitable recognition, it resumes with an #EasyVRResult (a failure
+  is reported as #EasyVRDispatcher::ON_TIMEOUT) */
+  class Recognize : public EasyVROperation
+  {
+    friend class EasyVRCoroutine;
+    int8_t _target;
+    EasyVRResult _result;
+    using EasyVROperation::EasyVROperation;
+  protected:
+    void start();
+    bool poll();
+    void fail();
+  public:
+    EasyVRResult await_resume() { return _result; }
+  };
+  /** Awaitable message playback, it resumes with true on success */
+  class PlayMessage : public EasyVROperation
+  {
+    friend class EasyVRCoroutine;
+    int8_t _index, _speed, _atten;
+    bool _ok;
+    using EasyVROperation::EasyVROperation;
+  protected:
+    void start();
+    bool poll();
+    void fail() { _ok = false; }
+  public:
+    bool await_resume() { return _ok; }
+  };
+  /** Awaitable command export, it resumes with true on success */
+  class ExportCommand : public EasyVROperation
+  {
+    friend class EasyVRCoroutine;
+    int8_t _group, _index;
+    uint8_t* _data;
+    int16_t _progress;
+    int8_t _status;
+    using EasyVROperation::EasyVROperation;
+  protected:
+    void start();
+    bool poll();
+    void fail() { _status = -1; }
+  public:
+    bool await_resume() { return _status > 0; }
+  };
+
+  /**
+    Creates an %EasyVR object driven by an event loop.
+    @param loop is the event loop that runs the coroutines
+    @param t is the transport connected to the module
+  */
+  EasyVRCoroutine(EasyVRLoop& loop, EasyVRPosixTransport& t) : _loop(loop), _t(t), _vr(t),
+    _busy(false), _limit(DEF_LIMIT) {}
+  /**
+    Gets the %EasyVR object, for the functions that are not awaitable.
+    @retval reference to the object
+  */
+  EasyVR& vr() { return _vr; }
+  /**
+    Sets the longest time a recognition or a playback may take. When it
+    expires, the operation is interrupted and fails. The default
+    (#DEF_LIMIT) is longer than the maximum recognition timeout of the
+    module, it should be raised to play long messages.
+    @param ms is the time limit in milliseconds, or (0) for no limit
+  */
+  void setTimeLimit(uint32_t ms) { _limit = ms; }
+  /**
+    Tells if an operation is pending on the module.
+    @retval true if an operation has been awaited and has not completed
+  */
+  bool isBusy() const { return _busy; }
+  /**
+    Recognizes custom commands (see #EasyVR::recognizeCommand()).
+    @param group (0-16) is the target group, or one of the values in #EasyVR::Group
+  */
+  Recognize recognize(int8_t group);
+  /**
+    Recognizes built-in words or custom grammars (see #EasyVR::recognizeWord()).
+    @param wordset (0-31) is the target word set, or one of the values in #EasyVR::Wordset
+  */
+  Recognize recognizeWord(int8_t wordset);
+  /**
+    Plays a recorded message (see #EasyVR::playMessageAsync()).
+    @param index (0-31) is the index of the target message slot
+    @param speed (0-1) may be one of the values in #EasyVR::MessageSpeed
+    @param atten (0-3) may be one of the values in #EasyVR::MessageAttenuation
+  */
+  PlayMessage playMessage(int8_t index, int8_t speed, int8_t atten);
+  /**
+    Retrieves all internal data associated to a custom command (see
+    #EasyVR::exportCommand()).
+    @param group (0-16) is the target group, or one of the values in #EasyVR::Group
+    @param index (0-31) is the index of the command within the selected group
+    @param data points to an array of at least 258 bytes that holds the
+    command raw data
+  */
+  ExportCommand exportCommand(int8_t group, int8_t index, uint8_t* data);
+};
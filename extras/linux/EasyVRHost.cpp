@@ -0,0 +1,160 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "Arduino.h"
+#include "EasyVRHost.h"
+
+/*****************************************************************************/
+
+EasyVRHost::EasyVRHost(EasyVRTransport& t) : _t(t), _vr(t), _cancel(false), _closing(false),
+  _limit(DEF_LIMIT), _running(true), _started(0)
+{
+  Node* stub = new Node();
+  stub->next = NULL;
+  _head = stub;
+  _tail = stub;
+  _event = eventfd(0, EFD_CLOEXEC);
+  _thread = std::thread(&EasyVRHost::run, this);
+}
+
+EasyVRHost::~EasyVRHost()
+{
+  _closing = true;
+  post([this]() { _running = false; });
+  _thread.join();
+
+  std::function<void()> task;
+  while (pop(task))
+    ; // discarded, the futures report a broken promise
+  delete _tail;
+  close(_event);
+}
+
+EasyVRResult EasyVRHost::interrupted()
+{
+  EasyVRResult r;
+  r.event = EasyVRDispatcher::ON_TIMEOUT;
+  r.set = -1;
+  r.value = 0;
+  r.time = millis();
+  return r;
+}
+
+void EasyVRHost::post(std::function<void()> task)
+{
+  // multiple producers, single consumer (intrusive Vyukov queue)
+  Node* node = new Node();
+  node->next.store(NULL, std::memory_order_relaxed);
+  node->task = std::move(task);
+  Node* prev = _head.exchange(node, std::memory_order_acq_rel);
+  prev->next.store(node, std::memory_order_release);
+
+  uint64_t one = 1;
+  if (write(_event, &one, sizeof(one)) < 0)
+    return; // counter saturated, the I/O thread is awake anyway
+}
+
+bool EasyVRHost::pop(std::function<void()>& task)
+{
+  Node* next = _tail->next.load(std::memory_order_acquire);
+  if (next == NULL)
+    return false;
+  // the popped node becomes the new stub
+  task = std::move(next->task);
+  delete _tail;
+  _tail = next;
+  return true;
+}
+
+std::future<EasyVRResult> EasyVRHost::recognizeCommand(int8_t group)
+{
+  std::shared_ptr<std::promise<EasyVRResult> > p = std::make_shared<std::promise<EasyVRResult> >();
+  recognizeCommand(group, [p](const EasyVRResult& r) { p->set_value(r); });
+  return p->get_future();
+}
+
+std::future<EasyVRResult> EasyVRHost::recognizeWord(int8_t wordset)
+{
+  std::shared_ptr<std::promise<EasyVRResult> > p = std::make_shared<std::promise<EasyVRResult> >();
+  recognizeWord(wordset, [p](const EasyVRResult& r) { p->set_value(r); });
+  return p->get_future();
+}
+
+void EasyVRHost::recognizeCommand(int8_t group, ResultCallback done)
+{
+  post([this, group, done]() { listen(group, done); });
+}
+
+void EasyVRHost::recognizeWord(int8_t wordset, ResultCallback done)
+{
+  post([this, wordset, done]() { listen(wordset + EasyVR::WORD_TARGET, done); });
+}
+
+void EasyVRHost::listen(int8_t target, ResultCallback done)
+{
+  if (_closing || _cancel.exchange(false))
+  {
+    done(interrupted()); // cancelled before it started
+    return;
+  }
+  if (target >= EasyVR::WORD_TARGET)
+    _vr.recognizeWord(target - EasyVR::WORD_TARGET);
+  else
+    _vr.recognizeCommand(target);
+  _pending = done;
+  _started = millis();
+}
+
+void EasyVRHost::run()
+{
+  while (_running)
+  {
+    std::function<void()> task;
+    if (_pending)
+    {
+      EasyVRResult r;
+      uint32_t limit = _limit;
+      bool cancelled = _closing || _cancel.exchange(false);
+      if (!cancelled && _vr.hasFinished())
+        EasyVRDispatcher::decode(_vr, r);
+      else if (cancelled || (limit != 0 && millis() - _started >= limit))
+      {
+        _vr.stop();
+        r = interrupted();
+      }
+      else
+      {
+        _t.wait(10); // check for cancellation often enough
+        continue;
+      }
+      ResultCallback done;
+      done.swap(_pending);
+      done(r);
+    }
+    else if (pop(task))
+      task();
+    else
+    {
+      struct pollfd p;
+      p.fd = _event;
+      p.events = POLLIN;
+      p.revents = 0;
+      poll(&p, 1, -1);
+      uint64_t count;
+      if (read(_event, &count, sizeof(count)) < 0)
+        continue;
+    }
+  }
+}
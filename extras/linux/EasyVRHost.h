@@ -0,0 +1,156 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <utility>
+#include "EasyVR.h"
+#include "EasyVRDispatcher.h"
+
+/*****************************************************************************/
+
+/**
+  Shares one %EasyVR module among the threads of a Linux program.
+
+  The %EasyVR object is owned by a dedicated I/O thread, and any thread can
+  submit work to it through a lock-free queue. Each request is a function
+  that receives the %EasyVR object and runs on the I/O thread, in order of
+  submission; its return value is delivered through a future or passed to
+  a callback (called on the I/O thread).
+
+  Recognition requests start a recognition and return at once: the I/O
+  thread keeps checking for the result and delivers it the same way, as
+  decoded by #EasyVRDispatcher::decode(). Requests submitted meanwhile wait
+  until the recognition completes, is interrupted with #cancel() or
+  exceeds the time limit (see #setTimeLimit()).
+*/
+class EasyVRHost
+{
+public:
+  enum
+  {
+    DEF_LIMIT = 35000, /**< Default time limit of recognitions (in ms) */
+  };
+
+  /** Type of the function that receives a recognition result */
+  typedef std::function<void(const EasyVRResult&)> ResultCallback;
+
+  /**
+    Creates the wrapper and starts the I/O thread.
+    @param t is the transport connected to the module (such as an
+    #EasyVRSerialTransport), only used by the I/O thread from now on
+  */
+  explicit EasyVRHost(EasyVRTransport& t);
+  /**
+    Interrupts a pending recognition, completes the requests already
+    submitted and stops the I/O thread.
+  */
+  ~EasyVRHost();
+
+  /**
+    Runs a function on the I/O thread.
+    @param f is a function (or lambda) taking an #EasyVR reference
+    @retval future is the result of the function
+  */
+  template <typename F>
+  auto call(F f) -> std::future<decltype(f(std::declval<EasyVR&>()))>
+  {
+    typedef decltype(f(std::declval<EasyVR&>())) R;
+    std::shared_ptr<std::packaged_task<R(EasyVR&)> > task =
+      std::make_shared<std::packaged_task<R(EasyVR&)> >(f);
+    std::future<R> result = task->get_future();
+    post([this, task]() { (*task)(_vr); });
+    return result;
+  }
+  /**
+    Runs a function on the I/O thread and passes its result to a callback.
+    @param f is a function (or lambda) taking an #EasyVR reference and
+    returning a value
+    @param done is the function that receives the value (on the I/O thread)
+  */
+  template <typename F, typename C>
+  void call(F f, C done)
+  {
+    post([this, f, done]() { done(f(_vr)); });
+  }
+  /**
+    Starts recognition of custom commands.
+    @param group (0-16) is the target group, or one of the values in #EasyVR::Group
+    @retval future is the result of recognition
+  */
+  std::future<EasyVRResult> recognizeCommand(int8_t group);
+  /**
+    Starts recognition of built-in words or custom grammars.
+    @param wordset (0-31) is the target word set, or one of the values in #EasyVR::Wordset
+    @retval future is the result of recognition
+  */
+  std::future<EasyVRResult> recognizeWord(int8_t wordset);
+  /**
+    Starts recognition of custom commands.
+    @param group (0-16) is the target group, or one of the values in #EasyVR::Group
+    @param done is the function that receives the result (on the I/O thread)
+  */
+  void recognizeCommand(int8_t group, ResultCallback done);
+  /**
+    Starts recognition of built-in words or custom grammars.
+    @param wordset (0-31) is the target word set, or one of the values in #EasyVR::Wordset
+    @param done is the function that receives the result (on the I/O thread)
+  */
+  void recognizeWord(int8_t wordset, ResultCallback done);
+  /**
+    Interrupts the pending recognition. Its result is reported as
+    #EasyVRDispatcher::ON_TIMEOUT. If no recognition is in progress, the
+    next one is interrupted as soon as it is executed.
+  */
+  void cancel() { _cancel = true; }
+  /**
+    Sets the longest time a recognition may keep the I/O thread busy. When
+    it expires, recognition is interrupted and reported as
+    #EasyVRDispatcher::ON_TIMEOUT, so that a dead link or an infinite
+    recognition timeout (see #EasyVR::setTimeout()) cannot block the
+    requests that follow. The default (#DEF_LIMIT) is longer than the
+    maximum recognition timeout of the module.
+    @param ms is the time limit in milliseconds, or (0) for no limit
+  */
+  void setTimeLimit(uint32_t ms) { _limit = ms; }
+
+private:
+  struct Node
+  {
+    std::atomic<Node*> next;
+    std::function<void()> task;
+  };
+
+  EasyVRTransport& _t;
+  EasyVR _vr;
+  std::atomic<Node*> _head;   // last submitted request (producers)
+  Node* _tail;                // already executed request (I/O thread)
+  int _event;                 // eventfd signalled on submission
+  std::atomic<bool> _cancel;
+  std::atomic<bool> _closing; // interrupt all recognitions
+  std::atomic<uint32_t> _limit;
+  bool _running;
+  ResultCallback _pending;    // recognition in progress (I/O thread)
+  unsigned long _started;     // time the pending recognition started
+  std::thread _thread;
+
+  static EasyVRResult interrupted();
+  void post(std::function<void()> task);
+  bool pop(std::function<void()>& task);
+  void listen(int8_t target, ResultCallback done);
+  void run();
+};
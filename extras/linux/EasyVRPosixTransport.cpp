@@ -0,0 +1,128 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include "EasyVRPosixTransport.h"
+
+/*****************************************************************************/
+
+static uint64_t now_us()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+EasyVRPosixTransport::EasyVRPosixTransport(int fd) : _fd(fd), _rx(-1), _due(0)
+{
+  int flags = fcntl(_fd, F_GETFL);
+  if (flags >= 0)
+    fcntl(_fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+bool EasyVRPosixTransport::pump()
+{
+  uint16_t* v;
+  while ((v = _tx.peek()) != NULL)
+  {
+    uint64_t t = now_us();
+    if (t < _due)
+      return false;
+    uint8_t c = *v & 0xFF;
+    ssize_t n = ::write(_fd, &c, 1);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR))
+      return false; // kernel buffer full, retry later
+    // drop the byte even on hard errors, the reply will time out
+    _due = t + (uint64_t)(*v >> 8) * 1000;
+    _tx.drop();
+  }
+  return true;
+}
+
+void EasyVRPosixTransport::idle()
+{
+  // sleep until the next byte is due, or until it can be written
+  struct pollfd p;
+  p.fd = _fd;
+  p.events = 0;
+  p.revents = 0;
+  int ms = 10;
+  uint64_t t = now_us();
+  if (_due > t)
+    ms = (_due - t + 999) / 1000;
+  else
+    p.events = POLLOUT;
+  poll(&p, 1, ms);
+}
+
+void EasyVRPosixTransport::start()
+{
+  pump();
+}
+
+void EasyVRPosixTransport::write(uint8_t c, uint8_t hold)
+{
+  while (_tx.full() && !pump())
+    idle();
+  EasyVRQueuedTransport<128>::write(c, hold);
+}
+
+int EasyVRPosixTransport::available()
+{
+  pump();
+  if (_rx < 0)
+  {
+    uint8_t c;
+    if (::read(_fd, &c, 1) == 1)
+      _rx = c;
+  }
+  return _rx < 0 ? 0 : 1;
+}
+
+int EasyVRPosixTransport::read()
+{
+  if (available() == 0)
+    return -1;
+  int c = _rx;
+  _rx = -1;
+  return c;
+}
+
+bool EasyVRPosixTransport::sending()
+{
+  return !pump();
+}
+
+void EasyVRPosixTransport::wait(uint16_t ms)
+{
+  if (!pump() && ms > 0)
+  {
+    // wake up when the next byte is due, or when it can be written
+    uint64_t t = now_us();
+    if (_due > t && (_due - t + 999) / 1000 < ms)
+      ms = (_due - t + 999) / 1000;
+  }
+  if (_rx >= 0 || ms == 0)
+    return;
+
+  struct pollfd p;
+  p.fd = _fd;
+  p.events = POLLIN;
+  if (!_tx.empty() && _due <= now_us())
+    p.events |= POLLOUT;
+  p.revents = 0;
+  poll(&p, 1, ms);
+}
@@ -0,0 +1,71 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "EasyVRTransport.h"
+
+/*****************************************************************************/
+
+/**
+  A native Linux implementation of #EasyVRTransport over a file descriptor
+  (a serial port, a pseudo-terminal, a pipe or a socket pair).
+
+  There is no interrupt to drive transmission, so queued bytes are pumped
+  out (with the required pauses) whenever the transport is used: any call
+  to #available(), #read(), #sending() or #commit() sends every byte that
+  is due at that time and returns without waiting. While the library waits
+  for a reply, #wait() sleeps in poll() until a byte is received or the
+  next queued byte is due.
+*/
+class EasyVRPosixTransport : public EasyVRQueuedTransport<128>
+{
+  int _fd;
+  int _rx; // one byte read-ahead (-1 if empty)
+  uint64_t _due; // time (in us) when the next byte can be sent
+
+  void idle();
+
+protected:
+  void start();
+
+public:
+  /**
+    Creates a transport over an open file descriptor.
+    @param fd is the descriptor, it is switched to non-blocking mode
+  */
+  EasyVRPosixTransport(int fd);
+  /**
+    Sends the bytes that are due, without waiting.
+    @retval true if the transmit queue is now empty
+  */
+  bool pump();
+  /**
+    Gets the underlying file descriptor (to use with poll() or select()).
+    @retval integer is the file descriptor
+  */
+  int fd() const { return _fd; }
+
+  /**
+    Queues one byte of the current command frame. When the transmit queue
+    is full, it sleeps until the next queued byte can be sent.
+    @param c is the byte to transmit
+    @param hold (0-255) is the minimum idle time in milliseconds that must
+    follow this byte
+  */
+  void write(uint8_t c, uint8_t hold);
+
+  int available();
+  int read();
+  bool sending();
+  void wait(uint16_t ms);
+};
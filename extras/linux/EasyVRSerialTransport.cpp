@@ -0,0 +1,83 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "EasyVRSerialTransport.h"
+
+/*****************************************************************************/
+
+static speed_t speed(uint32_t bps)
+{
+  switch (bps)
+  {
+  case 9600: return B9600;
+  case 19200: return B19200;
+  case 38400: return B38400;
+  case 57600: return B57600;
+  case 115200: return B115200;
+  }
+  return B0;
+}
+
+int EasyVRSerialTransport::openPort(const char* path, uint32_t bps)
+{
+  int fd = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0)
+    return -1;
+
+  struct termios tio;
+  if (speed(bps) == B0 || tcgetattr(fd, &tio) < 0)
+  {
+    ::close(fd);
+    return -1;
+  }
+  cfmakeraw(&tio);
+  tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+  tio.c_cflag |= CLOCAL | CREAD;
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = 0;
+  cfsetispeed(&tio, speed(bps));
+  cfsetospeed(&tio, speed(bps));
+  if (tcsetattr(fd, TCSANOW, &tio) < 0)
+  {
+    ::close(fd);
+    return -1;
+  }
+  tcflush(fd, TCIOFLUSH);
+  return fd;
+}
+
+EasyVRSerialTransport::EasyVRSerialTransport(const char* path, uint32_t bps)
+  : EasyVRPosixTransport(openPort(path, bps))
+{
+}
+
+EasyVRSerialTransport::~EasyVRSerialTransport()
+{
+  if (fd() >= 0)
+    ::close(fd());
+}
+
+bool EasyVRSerialTransport::setBaudrate(uint32_t bps)
+{
+  struct termios tio;
+  if (fd() < 0 || speed(bps) == B0 || tcgetattr(fd(), &tio) < 0)
+    return false;
+  while (!pump())
+    wait(1);
+  tcdrain(fd());
+  cfsetispeed(&tio, speed(bps));
+  cfsetospeed(&tio, speed(bps));
+  return tcsetattr(fd(), TCSANOW, &tio) == 0;
+}
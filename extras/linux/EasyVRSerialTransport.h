@@ -0,0 +1,57 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "EasyVRPosixTransport.h"
+
+/*****************************************************************************/
+
+/**
+  A native Linux serial port transport, configured with termios (raw mode,
+  8 data bits, no parity, 1 stop bit, no flow control).
+
+  Reads are non-blocking and waiting for replies sleeps in poll(), as in
+  #EasyVRPosixTransport. The descriptor returned by #fd() can also be added
+  to an application event loop (poll or epoll), to call the non-blocking
+  functions of the library only when data is available.
+*/
+class EasyVRSerialTransport : public EasyVRPosixTransport
+{
+  static int openPort(const char* path, uint32_t bps);
+
+public:
+  /**
+    Opens and configures a serial port.
+    @param path is the device name (for example "/dev/ttyUSB0")
+    @param bps is the communication speed in bits per second (the module
+    starts at 9600)
+    @note Check with #isOpen() that the port has been opened successfully.
+  */
+  EasyVRSerialTransport(const char* path, uint32_t bps = 9600);
+  /**
+    Closes the serial port.
+  */
+  ~EasyVRSerialTransport();
+  /**
+    Tells if the serial port is open.
+    @retval true if the port can be used
+  */
+  bool isOpen() const { return fd() >= 0; }
+  /**
+    Changes the speed of the serial port, after pending output has been
+    transmitted (see #EasyVR::negotiateBaudrate()).
+    @param bps is the new speed in bits per second
+    @retval true if the speed is supported and has been set
+  */
+  bool setBaudrate(uint32_t bps);
+};
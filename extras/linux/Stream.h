@@ -0,0 +1,47 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*****************************************************************************/
+
+/**
+  The subset of the Arduino Print interface used by the EasyVR library.
+*/
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size)
+  {
+    size_t n = 0;
+    while (size-- > 0)
+      n += write(*buffer++);
+    return n;
+  }
+  virtual void flush() {}
+};
+
+/**
+  The subset of the Arduino Stream interface used by the EasyVR library.
+*/
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
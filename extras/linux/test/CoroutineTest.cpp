@@ -0,0 +1,124 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+// Checks the C++20 coroutine front-end against a simulated module: awaited
+// recognition, playback and command export, the time limit and the
+// rejection of concurrent operations. Requires C++20.
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "EasyVRCoroutine.h"
+#include "EasyVRSimulator.h"
+
+static int failures;
+
+#define CHECK(cond) check(cond, #cond, __LINE__)
+
+static void check(bool ok, const char* what, int line)
+{
+  if (ok)
+    return;
+  printf("FAIL line %d: %s\n", line, what);
+  ++failures;
+}
+
+static void module(EasyVRSimulator& sim, uint8_t cmd)
+{
+  switch (cmd)
+  {
+  case 'd': // CMD_RECOG_SD, group 2 never completes
+    if (sim.arg() == 2)
+      break;
+    delay(20);
+    sim.queueArg(5);
+    sim.reply('r'); // STS_RESULT
+    break;
+  case 'p': // CMD_PLAY_RP
+    sim.arg();
+    sim.arg();
+    sim.arg();
+    delay(20);
+    sim.reply('o'); // STS_SUCCESS
+    break;
+  case '~': // CMD_SERVICE, export of a command
+    sim.arg();
+    sim.arg();
+    sim.arg();
+    sim.queueRaw('D'); // SVC_DUMP_SD
+    for (int i = 0; i < 258; ++i)
+    {
+      sim.queueArg((i >> 4) & 0x0F);
+      sim.queueArg(i & 0x0F);
+    }
+    sim.reply('~'); // STS_SERVICE
+    break;
+  case 'b': // CMD_BREAK
+    sim.reply('i'); // STS_INTERR
+    break;
+  }
+}
+
+static EasyVRResult first, busy, limited;
+static bool played;
+static bool exported;
+static uint8_t data[258];
+static bool done;
+
+static EasyVRTask sequence(EasyVRCoroutine& vr)
+{
+  first = co_await vr.recognize(1);
+  played = co_await vr.playMessage(1, 0, 0);
+  exported = co_await vr.exportCommand(1, 3, data);
+  vr.setTimeLimit(100);
+  limited = co_await vr.recognize(2);
+  done = true;
+}
+
+static EasyVRTask intruder(EasyVRCoroutine& vr)
+{
+  busy = co_await vr.recognize(1);
+}
+
+int main()
+{
+  EasyVRSimulator sim;
+  sim.start(module);
+  EasyVRPosixTransport port(sim.fd());
+  EasyVRLoop loop;
+  EasyVRCoroutine vr(loop, port);
+
+  unsigned long start = millis();
+  sequence(vr);
+  CHECK(vr.isBusy());
+  intruder(vr); // while the first recognition is in progress
+  CHECK(busy.event == EasyVRDispatcher::ON_TIMEOUT && busy.set == -1);
+  loop.run();
+  unsigned long ms = millis() - start;
+
+  CHECK(done);
+  CHECK(!vr.isBusy());
+  CHECK(first.event == EasyVRDispatcher::ON_COMMAND);
+  CHECK(first.set == 1 && first.value == 5);
+  CHECK(played);
+  CHECK(exported);
+  bool same = true;
+  for (int i = 0; i < 258; ++i)
+    same = same && data[i] == (uint8_t)i;
+  CHECK(same);
+  CHECK(limited.event == EasyVRDispatcher::ON_TIMEOUT);
+  CHECK(ms >= 100 && ms < 2000);
+  printf("sequence completed in %lu ms\n", ms);
+
+  if (failures == 0)
+    printf("all tests passed\n");
+  return failures != 0;
+}
@@ -0,0 +1,141 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+// A scripted EasyVR module on the other end of a socket pair, for host tests.
+// The library talks to fd() (usually through an EasyVRPosixTransport), and
+// a thread passes each command character to the handler, that reads the
+// arguments with arg() and answers with reply(). Reply arguments queued
+// with queueArg() are sent one at a time, when the library asks for them.
+// The module side can also be an existing descriptor, such as the master
+// of a pseudo-terminal, whose slave is then opened by the library.
+
+#pragma once
+
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/*****************************************************************************/
+
+class EasyVRSimulator
+{
+public:
+  typedef std::function<void(EasyVRSimulator& sim, uint8_t cmd)> Handler;
+
+  EasyVRSimulator() : _silent(false)
+  {
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, _fd) < 0)
+      _fd[0] = _fd[1] = -1;
+  }
+  /** Uses the given descriptor for the module side (closed when done). The
+  other side must be closed before the simulator is destroyed. */
+  explicit EasyVRSimulator(int moduleFd) : _silent(false)
+  {
+    _fd[0] = -1;
+    _fd[1] = moduleFd;
+  }
+  ~EasyVRSimulator()
+  {
+    shutdown(_fd[1], SHUT_RDWR);
+    if (_thread.joinable())
+      _thread.join();
+    if (_fd[0] >= 0)
+      close(_fd[0]);
+    close(_fd[1]);
+  }
+  /** Gets the descriptor the library must use (-1 for an existing one). */
+  int fd() const { return _fd[0]; }
+  /** Starts answering commands with the given handler. */
+  void start(Handler handler)
+  {
+    _handler = handler;
+    _thread = std::thread([this]() { run(); });
+  }
+  /** Ignores all received bytes, as a module that is not connected. */
+  void setSilent(bool silent) { _silent = silent; }
+  /** Reads the next byte from the library (blocking). */
+  uint8_t get()
+  {
+    uint8_t c = 0;
+    if (::read(_fd[1], &c, 1) == 1)
+      log(c);
+    return c;
+  }
+  /** Reads the next command argument. */
+  int8_t arg() { return (int8_t)(get() - ARG_ZERO); }
+  /** Sends a status or raw byte to the library. */
+  void reply(uint8_t c)
+  {
+    if (::write(_fd[1], &c, 1) != 1)
+      return;
+  }
+  /** Queues a reply argument, sent when the library acknowledges. */
+  void queueArg(int8_t a) { queueRaw((uint8_t)(a + ARG_ZERO)); }
+  /** Queues a raw byte, sent when the library acknowledges. */
+  void queueRaw(uint8_t c)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _args.push_back(c);
+  }
+  /** Gets all the bytes received so far. */
+  std::string received()
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _log;
+  }
+
+private:
+  enum { ARG_ZERO = 0x41, ARG_ACK = 0x20 };
+
+  int _fd[2];
+  std::thread _thread;
+  Handler _handler;
+  std::mutex _mutex;
+  std::deque<uint8_t> _args;
+  std::string _log;
+  std::atomic<bool> _silent;
+
+  void log(uint8_t c)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _log += (char)c;
+  }
+
+  void run()
+  {
+    uint8_t c;
+    while (::read(_fd[1], &c, 1) == 1)
+    {
+      log(c);
+      if (_silent)
+        continue;
+      if (c == ARG_ACK)
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_args.empty())
+          continue;
+        c = _args.front();
+        _args.pop_front();
+        lock.unlock();
+        reply(c);
+      }
+      else if (_handler)
+        _handler(*this, c);
+    }
+  }
+};
@@ -0,0 +1,126 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+// Measures throughput and latency of EasyVRHost requests from several
+// producer threads, with and without module I/O, then checks that
+// recognitions cannot block the I/O thread.
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "Arduino.h"
+#include "EasyVRHost.h"
+#include "EasyVRPosixTransport.h"
+#include "EasyVRSimulator.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static void module(EasyVRSimulator& sim, uint8_t cmd)
+{
+  switch (cmd)
+  {
+  case 'x': // CMD_ID
+    sim.reply('x');
+    sim.queueArg(EasyVR::EASYVR3);
+    break;
+  case 'd': // CMD_RECOG_SD, never completes
+    sim.arg();
+    break;
+  case 'b': // CMD_BREAK
+    sim.reply('i');
+    break;
+  }
+}
+
+static void measure(EasyVRHost& host, const char* name, bool io, int threads, int requests)
+{
+  std::vector<std::vector<double> > latency(threads);
+  std::vector<std::thread> producers;
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < threads; ++i)
+  {
+    producers.push_back(std::thread([&host, &latency, i, io, requests]() {
+      for (int n = 0; n < requests; ++n)
+      {
+        Clock::time_point t = Clock::now();
+        int id = host.call([io](EasyVR& vr) { return io ? vr.getID() : 0; }).get();
+        if (id < 0)
+          printf("FAIL: no reply\n");
+        latency[i].push_back(std::chrono::duration<double, std::micro>(Clock::now() - t).count());
+      }
+    }));
+  }
+  for (size_t i = 0; i < producers.size(); ++i)
+    producers[i].join();
+  double secs = std::chrono::duration<double>(Clock::now() - start).count();
+
+  std::vector<double> all;
+  for (int i = 0; i < threads; ++i)
+    all.insert(all.end(), latency[i].begin(), latency[i].end());
+  std::sort(all.begin(), all.end());
+  printf("%-8s %d threads: %8.0f requests/s, latency p50 %7.1f us, p99 %7.1f us, max %7.1f us\n",
+    name, threads, all.size() / secs, all[all.size() / 2], all[all.size() * 99 / 100], all.back());
+}
+
+static bool checkLimits(EasyVRHost& host)
+{
+  // a recognition that never completes is stopped at the time limit
+  host.setTimeLimit(200);
+  std::future<EasyVRResult> r = host.recognizeCommand(1);
+  std::future<int8_t> id = host.call([](EasyVR& vr) { return vr.getID(); });
+  if (id.wait_for(std::chrono::seconds(2)) != std::future_status::ready ||
+    r.get().event != EasyVRDispatcher::ON_TIMEOUT || id.get() != EasyVR::EASYVR3)
+  {
+    printf("FAIL: recognition not stopped at the time limit\n");
+    return false;
+  }
+  // a cancellation made before the recognition starts is not lost
+  host.setTimeLimit(0);
+  std::promise<void> gate;
+  std::shared_future<void> open = gate.get_future().share();
+  host.call([open](EasyVR&) { open.wait(); return 0; });
+  r = host.recognizeCommand(1);
+  host.cancel();
+  gate.set_value();
+  if (r.wait_for(std::chrono::seconds(2)) != std::future_status::ready)
+  {
+    printf("FAIL: early cancellation lost\n");
+    return false;
+  }
+  printf("time limit and early cancellation: ok\n");
+  return true;
+}
+
+int main()
+{
+  EasyVRSimulator sim;
+  sim.start(module);
+  EasyVRPosixTransport port(sim.fd());
+  {
+    EasyVRHost host(port);
+    static const int threads[] = { 1, 2, 4, 8 };
+    for (int i = 0; i < 4; ++i)
+      measure(host, "queue", false, threads[i], 20000 / threads[i]);
+    for (int i = 0; i < 4; ++i)
+      measure(host, "getID", true, threads[i], 200 / threads[i]);
+    if (!checkLimits(host))
+      return 1;
+
+    // leave recognitions queued, the destructor must not wait for them
+    host.setTimeLimit(0);
+    host.recognizeCommand(1);
+    host.recognizeWord(EasyVR::TRIGGER_SET);
+  }
+  printf("destroyed with queued recognitions: ok\n");
+  return 0;
+}
@@ -0,0 +1,86 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+// Measures the cost of EasyVRMouthFilter per sample: one input frame every
+// 27 ms (the lip-sync refresh) and one output value every millisecond.
+
+#include <stdio.h>
+#include <time.h>
+#include "EasyVRMouthFilter.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+static uint64_t now_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int main()
+{
+  const unsigned long FRAMES = 1000000, FRAME_MS = 27;
+  EasyVRMouthFilter filter;
+  EasyVRMouthFrame f;
+  unsigned long t = millis(), samples = 0;
+  uint32_t sum = 0;
+  uint32_t seed = 12345;
+
+  uint64_t ns = now_ns();
+#ifdef HAVE_TSC
+  uint64_t tsc = __rdtsc();
+#endif
+  for (unsigned long i = 0; i < FRAMES; ++i)
+  {
+    seed = seed * 1103515245 + 12345;
+    f.position = (seed >> 16) & 0x1F;
+    f.time = t;
+    filter.push(f);
+    for (unsigned long k = 0; k < FRAME_MS; ++k, ++samples)
+      sum += filter.value(t + k);
+    t += FRAME_MS;
+  }
+#ifdef HAVE_TSC
+  tsc = __rdtsc() - tsc;
+#endif
+  ns = now_ns() - ns;
+
+  printf("%lu frames, %lu output samples (checksum %u)\n", FRAMES, samples, sum);
+  printf("%.2f ns per output sample\n", (double)ns / samples);
+#ifdef HAVE_TSC
+  printf("%.1f cycles per output sample (TSC)\n", (double)tsc / samples);
+#endif
+
+  // after a pause, the output must move to the new position over about one
+  // frame period, neither jumping nor crawling over the whole pause
+  f.position = 0;
+  for (int i = 0; i < 50; ++i, t += FRAME_MS)
+  {
+    f.time = t;
+    filter.push(f);
+  }
+  f.position = 31;
+  f.time = t + 65536UL + 10;
+  filter.push(f);
+  uint8_t target = filter.value(f.time + 1000);
+  uint8_t early = filter.value(f.time + 5);
+  uint8_t late = filter.value(f.time + FRAME_MS + 1);
+  if (early == 0 || early >= target || late != target)
+  {
+    printf("FAIL: output %u, %u after a long pause (target %u)\n", early, late, target);
+    return 1;
+  }
+  return 0;
+}
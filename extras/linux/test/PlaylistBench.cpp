@@ -0,0 +1,94 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+// Plays a mixed playlist of sounds, messages and tones on a simulated
+// module and measures the gap between the end of an item and the start
+// of the next one.
+
+#include <stdio.h>
+#include "EasyVRPlaylist.h"
+#include "EasyVRPosixTransport.h"
+#include "EasyVRSimulator.h"
+
+static const int ITEMS = 200;
+static const int PLAY_MS = 5;   // simulated duration of each item
+
+static unsigned long ended;     // time the last item ended (in us)
+static unsigned long totalGap;
+static unsigned long maxGap;
+static int started;
+
+static void module(EasyVRSimulator& sim, uint8_t cmd)
+{
+  if (cmd != 'w' && cmd != 'p')
+    return;
+  if (started++ > 0)
+  {
+    unsigned long gap = micros() - ended;
+    totalGap += gap;
+    if (gap > maxGap)
+      maxGap = gap;
+  }
+  sim.arg();
+  sim.arg();
+  sim.arg();
+  delay(PLAY_MS);
+  ended = micros();
+  sim.reply('o'); // STS_SUCCESS
+}
+
+int main()
+{
+  EasyVRSimulator sim;
+  sim.start(module);
+  EasyVRPosixTransport port(sim.fd());
+  EasyVR easyvr(port);
+  EasyVRPlaylist<8> list(easyvr);
+
+  int queued = 0;
+  unsigned long start = millis();
+  while (queued < ITEMS || list.isPlaying() || list.available() > 0)
+  {
+    while (queued < ITEMS)
+    {
+      bool ok;
+      switch (queued % 3)
+      {
+      case 0: ok = list.addSound(queued, EasyVR::VOL_FULL); break;
+      case 1: ok = list.addMessage(queued % 32, EasyVR::SPEED_NORMAL, EasyVR::ATTEN_NONE); break;
+      default: ok = list.addTone(queued % 10, 1); break;
+      }
+      if (!ok)
+        break;
+      ++queued;
+    }
+    if (!list.poll())
+      port.wait(PLAY_MS);
+    if (millis() - start > 10000UL)
+    {
+      printf("FAIL: playlist stalled after %d items\n", started);
+      return 1;
+    }
+  }
+
+  printf("%d items played in %lu ms, %u errors\n", started, millis() - start, list.getErrors());
+  printf("gap between items: %.1f us average, %lu us max (module side)\n",
+    (double)totalGap / (started - 1), maxGap);
+  printf("re-arm time: %lu us max, poll interval: %lu us max (measured by the playlist)\n",
+    list.getMaxGap(), list.getMaxPollInterval());
+  if (started != ITEMS || list.getErrors() != 0)
+  {
+    printf("FAIL\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,113 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+// Checks that EasyVRPower keeps the recognition in progress going, when
+// the module refuses to sleep and when it wakes up.
+
+#include <stdio.h>
+#include <atomic>
+#include <string>
+#include "Arduino.h"
+#include "EasyVRPower.h"
+#include "EasyVRPosixTransport.h"
+#include "EasyVRSimulator.h"
+
+static int failures;
+
+#define CHECK(cond) check(cond, #cond, __LINE__)
+
+static void check(bool ok, const char* what, int line)
+{
+  if (ok)
+    return;
+  printf("FAIL line %d: %s\n", line, what);
+  ++failures;
+}
+
+static std::atomic<bool> refuse(true);
+static std::atomic<bool> recognizing(false);
+
+static void module(EasyVRSimulator& sim, uint8_t cmd)
+{
+  switch (cmd)
+  {
+  case 'd': // CMD_RECOG_SD, completes only when interrupted
+    sim.arg();
+    recognizing = true;
+    break;
+  case 'b': // CMD_BREAK
+    sim.reply(recognizing ? 'i' : 'o');
+    recognizing = false;
+    break;
+  case 's': // CMD_SLEEP
+    sim.arg();
+    sim.reply(refuse ? 'v' : 'o');
+    break;
+  }
+}
+
+// number of recognitions of group 3 started so far
+static int started(EasyVRSimulator& sim)
+{
+  std::string log = sim.received();
+  int n = 0;
+  for (size_t i = log.find("dD"); i != std::string::npos; i = log.find("dD", i + 2))
+    ++n;
+  return n;
+}
+
+// sends the queued bytes until the simulator receives a new recognition
+static bool restarted(EasyVRSimulator& sim, EasyVRPosixTransport& port, int count)
+{
+  for (int i = 0; i < 100 && started(sim) <= count; ++i)
+    port.wait(1);
+  return started(sim) > count && recognizing;
+}
+
+int main()
+{
+  EasyVRSimulator sim;
+  sim.start(module);
+  EasyVRPosixTransport port(sim.fd());
+  EasyVR easyvr(port);
+  EasyVRPower power(easyvr);
+
+  easyvr.recognizeCommand(3);
+  CHECK(restarted(sim, port, 0));
+
+  // sleep refused: the interrupted recognition must be restarted
+  CHECK(!power.sleep());
+  CHECK(power.isAwake());
+  CHECK(easyvr.isRecognizing());
+  CHECK(restarted(sim, port, 1));
+
+  // sleep accepted, then a wake-up event from the module
+  refuse = false;
+  CHECK(power.sleep());
+  CHECK(!power.isAwake());
+  CHECK(!recognizing);
+  sim.reply('w'); // STS_AWAKEN
+  bool woken = false;
+  for (int i = 0; i < 100 && !woken; ++i, delay(1))
+    woken = power.poll();
+  CHECK(woken);
+  CHECK(power.isAwake());
+  CHECK(easyvr.isRecognizing());
+  CHECK(restarted(sim, port, 2));
+  CHECK(power.getWakeups() == 1);
+  printf("wake latency %lu us, poll interval %lu us max\n",
+    power.getWakeLatency(), power.getMaxPollInterval());
+
+  if (failures == 0)
+    printf("all tests passed\n");
+  return failures != 0;
+}
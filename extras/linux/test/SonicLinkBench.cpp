@@ -0,0 +1,224 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+// Sends frames with EasyVRSonicLink to a simulated module, whose tokens go
+// through a lossy audio channel into a second EasyVRSonicLink decoder, and
+// reports effective payload throughput and frame error rate.
+//
+// The loss runs use an in-process module that answers each token at once,
+// so that they can send enough frames for meaningful error rates. Their
+// throughput is scaled by the token time measured over EasyVRSimulator,
+// with the real transport and its pauses between bytes.
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "EasyVRSonicLink.h"
+#include "EasyVRPosixTransport.h"
+#include "EasyVRSimulator.h"
+
+static const int FRAMES = 500;  // frames per loss run
+static const int TOKEN_MS = 1;  // simulated duration of each token
+
+static EasyVRSonicLink* rx;
+static int lossPerMille;        // chance of losing or corrupting a token
+static uint32_t seed = 1;
+static unsigned long tokens;
+static int good;                // frames delivered with the expected payload
+static int bad;                 // frames delivered with a wrong payload
+
+static uint32_t random16()
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) & 0xFFFF;
+}
+
+// passes a transmitted token through the channel to the decoder
+static void channel(uint8_t token, unsigned long time)
+{
+  ++tokens;
+  EasyVRResult r = { EasyVRDispatcher::ON_TOKEN, -1, token, time };
+  int roll = random16() % 1000;
+  if (roll < lossPerMille / 2)
+    r.value ^= 1 << (random16() % 8); // corrupted
+  else if (roll < lossPerMille)
+    r.event = EasyVRDispatcher::ON_TIMEOUT; // lost
+  if (rx->receive(r))
+  {
+    const uint8_t* data = rx->getData();
+    bool ok = rx->getLength() == EasyVRSonicLink::MAX_PAYLOAD;
+    for (uint8_t i = 1; ok && i < rx->getLength(); ++i)
+      ok = data[i] == (uint8_t)(data[0] * 7 + i);
+    ok ? ++good : ++bad;
+  }
+}
+
+static void module(EasyVRSimulator& sim, uint8_t cmd)
+{
+  if (cmd != 'j') // CMD_SEND_SN
+    return;
+  sim.arg();
+  uint8_t token = sim.arg() << 5;
+  token |= sim.arg();
+  sim.arg();
+  sim.arg();
+  delay(TOKEN_MS);
+  channel(token, millis());
+  sim.reply('o'); // STS_SUCCESS
+}
+
+// A module that plays each token as soon as the command is committed, with
+// no pauses and a virtual clock of TOKEN_MS per token
+class InstantModule : public EasyVRTransport
+{
+  enum { ARG_ZERO = 0x41 };
+  uint8_t _cmd[6];
+  uint8_t _len;
+  int _reply;
+
+public:
+  InstantModule() : _len(0), _reply(-1) {}
+  int available() { return _reply >= 0 ? 1 : 0; }
+  int read()
+  {
+    int c = _reply;
+    _reply = -1;
+    return c;
+  }
+  void write(uint8_t c, uint8_t hold)
+  {
+    (void)hold;
+    if (_len < sizeof(_cmd))
+      _cmd[_len++] = c;
+  }
+  void commit()
+  {
+    if (_len == sizeof(_cmd) && _cmd[0] == 'j') // CMD_SEND_SN
+    {
+      uint8_t token = ((_cmd[2] - ARG_ZERO) << 5) | (_cmd[3] - ARG_ZERO);
+      channel(token, tokens * TOKEN_MS);
+      _reply = 'o'; // STS_SUCCESS
+    }
+    _len = 0;
+  }
+  bool sending() { return false; }
+};
+
+static bool send(EasyVRSonicLink& tx, int frames)
+{
+  uint8_t data[EasyVRSonicLink::MAX_PAYLOAD];
+  for (int f = 0; f < frames; ++f)
+  {
+    data[0] = f;
+    for (uint8_t i = 1; i < sizeof(data); ++i)
+      data[i] = f * 7 + i;
+    if (!tx.write(data, sizeof(data)))
+    {
+      printf("FAIL: frame %d not sent\n", f);
+      return false;
+    }
+  }
+  return true;
+}
+
+static void reset(EasyVRSonicLink& decoder, int permille)
+{
+  rx = &decoder;
+  lossPerMille = permille;
+  tokens = 0;
+  good = bad = 0;
+}
+
+// measures the time per token through the real transport, without losses
+static double measure(EasyVRSonicLink& decoder)
+{
+  const int frames = 16;
+  EasyVRSimulator sim;
+  EasyVRPosixTransport port(sim.fd());
+  EasyVR easyvr(port);
+  EasyVRSonicLink tx(easyvr);
+
+  reset(decoder, 0);
+  sim.start(module);
+  unsigned long start = millis();
+  if (!send(tx, frames))
+    return 0;
+  unsigned long ms = millis() - start;
+  if (good != frames || bad != 0)
+  {
+    printf("FAIL: %d of %d frames received (%d bad)\n", good, frames, bad);
+    return 0;
+  }
+  return (double)ms / tokens;
+}
+
+static bool run(EasyVRSonicLink& decoder, int permille, uint8_t repeat, double tokenMs)
+{
+  InstantModule module;
+  EasyVR easyvr(module);
+  EasyVRSonicLink tx(easyvr);
+
+  reset(decoder, permille);
+  tx.setRepeat(repeat);
+  if (!send(tx, FRAMES))
+    return false;
+
+  double bytes = (double)good * EasyVRSonicLink::MAX_PAYLOAD;
+  printf("loss %4.1f%%, repeat %u: %5.1f bytes/s, %4.2f bytes/token, "
+    "frame error rate %5.1f%% (%d bad)\n", permille / 10.0, repeat,
+    bytes * 1000.0 / (tokens * tokenMs), bytes / tokens,
+    100.0 * (FRAMES - good) / FRAMES, bad);
+  return permille != 0 || (good == FRAMES && bad == 0);
+}
+
+int main()
+{
+  InstantModule idle;
+  EasyVR rxModule(idle); // never used for I/O, needed by the decoder
+
+  EasyVRSonicLink probe(rxModule);
+  double tokenMs = measure(probe);
+  if (tokenMs == 0)
+    return 1;
+  printf("simulated token time %d ms, %.1f ms per token with the transport\n",
+    TOKEN_MS, tokenMs);
+
+  static const int loss[] = { 0, 10, 50 };
+  for (uint8_t i = 0; i < sizeof(loss) / sizeof(loss[0]); ++i)
+  {
+    for (uint8_t repeat = 1; repeat <= 2; ++repeat)
+    {
+      EasyVRSonicLink decoder(rxModule);
+      if (!run(decoder, loss[i], repeat, tokenMs))
+        return 1;
+    }
+  }
+
+  // a module that does not answer must not block write() forever
+  EasyVRSimulator dead;
+  dead.setSilent(true);
+  dead.start(module);
+  EasyVRPosixTransport deadPort(dead.fd());
+  EasyVR deadModule(deadPort);
+  deadModule.setReplyTimeout(EasyVR::TIMEOUT_TOKEN, 100);
+  EasyVRSonicLink link(deadModule);
+  uint8_t byte = 0;
+  unsigned long start = millis();
+  bool sent = link.write(&byte, 1);
+  unsigned long ms = millis() - start;
+  printf("dead module: write() gave up after %lu ms\n", ms);
+  if (sent || link.getSendErrors() != 1 || ms > 500)
+  {
+    printf("FAIL\n");
+    return 1;
+  }
+  return 0;
+}
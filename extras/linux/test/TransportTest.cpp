@@ -0,0 +1,132 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+// Checks the Linux transports against a simulated module, over a socket
+// pair and over a pseudo-terminal, and that the per-byte pauses are timed
+// waits rather than busy loops.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Arduino.h"
+#include "EasyVR.h"
+#include "EasyVRSerialTransport.h"
+#include "EasyVRSimulator.h"
+
+static int failures;
+
+#define CHECK(cond) check(cond, #cond, __LINE__)
+
+static void check(bool ok, const char* what, int line)
+{
+  if (ok)
+    return;
+  printf("FAIL line %d: %s\n", line, what);
+  ++failures;
+}
+
+static double cpu_ms()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void module(EasyVRSimulator& sim, uint8_t cmd)
+{
+  switch (cmd)
+  {
+  case 'x': // CMD_ID
+    sim.reply('x');
+    sim.queueArg(EasyVR::EASYVR3);
+    break;
+  case '~': // CMD_SERVICE, import of a command
+    sim.arg();
+    sim.arg();
+    sim.arg();
+    for (int i = 0; i < 516; ++i)
+      sim.arg();
+    sim.reply('o');
+    break;
+  }
+}
+
+static void testSocket()
+{
+  EasyVRSimulator sim;
+  sim.start(module);
+  EasyVRPosixTransport port(sim.fd());
+  EasyVR easyvr(port);
+
+  CHECK(easyvr.getID() == EasyVR::EASYVR3);
+
+  // 520 bytes with 1 ms pauses overflow the transmit queue
+  uint8_t data[258];
+  for (int i = 0; i < 258; ++i)
+    data[i] = i;
+  unsigned long start = millis();
+  double cpu = cpu_ms();
+  CHECK(easyvr.importCommand(1, 2, data));
+  cpu = cpu_ms() - cpu;
+  unsigned long ms = millis() - start;
+  printf("importCommand: %lu ms, %.1f ms of CPU\n", ms, cpu);
+  CHECK(ms >= 500);
+  CHECK(cpu < ms / 10.0);
+}
+
+static void testPty()
+{
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  CHECK(master >= 0);
+  if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0)
+    return;
+  EasyVRSimulator sim(master);
+  sim.start(module);
+
+  EasyVRTransport* port = new EasyVRSerialTransport(ptsname(master), 9600);
+  int fd = static_cast<EasyVRSerialTransport*>(port)->fd();
+  CHECK(fd >= 0);
+  {
+    EasyVR easyvr(*port);
+    CHECK(easyvr.getID() == EasyVR::EASYVR3);
+    CHECK(static_cast<EasyVRSerialTransport*>(port)->setBaudrate(115200));
+    CHECK(easyvr.getID() == EasyVR::EASYVR3);
+
+    // waiting for a reply that never comes must sleep
+    easyvr.setReplyTimeout(EasyVR::TIMEOUT_DEFAULT, 300);
+    sim.setSilent(true);
+    double cpu = cpu_ms();
+    CHECK(easyvr.getID() < 0);
+    cpu = cpu_ms() - cpu;
+    printf("missing reply: %.1f ms of CPU in 300 ms\n", cpu);
+    CHECK(cpu < 30);
+  }
+  // deleting through the base class must close the port
+  delete port;
+  bool closed = fcntl(fd, F_GETFD) < 0 && errno == EBADF;
+  CHECK(closed);
+  if (!closed)
+    close(fd); // let the simulator stop
+}
+
+int main()
+{
+  setvbuf(stdout, NULL, _IONBF, 0);
+  testSocket();
+  testPty();
+  if (failures != 0)
+    return 1;
+  printf("all tests passed\n");
+  return 0;
+}
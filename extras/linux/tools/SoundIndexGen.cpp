@@ -0,0 +1,158 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+// Generates an index for EasyVRSoundIndex from the list of sound names, as a
+// header with a PROGMEM array and optionally as a binary blob. Names are read
+// from the standard input, one per line in sound table order, starting from
+// index 1 (an empty line skips one sound). Entries are sorted by hash, and
+// hash collisions are reported as errors.
+//
+//   SoundIndexGen [-p prefix] [-b file.bin] table_name < names.txt > index.h
+//
+// The header defines <prefix>_NAME, _COUNT, _SIZE and _INDEX (the default
+// prefix is SOUND_TABLE), to be used as:
+//
+//   index.begin(SOUND_TABLE_NAME, SOUND_TABLE_COUNT, SOUND_TABLE_INDEX,
+//     SOUND_TABLE_SIZE, true);
+
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "EasyVRSoundIndex.h"
+
+struct Sound
+{
+  std::string name;
+  EasyVRSoundEntry entry;
+
+  bool operator<(const Sound& other) const { return entry.hash < other.entry.hash; }
+};
+
+static std::string trim(const std::string& s)
+{
+  size_t b = s.find_first_not_of(" \t\r\n");
+  if (b == std::string::npos)
+    return std::string();
+  size_t e = s.find_last_not_of(" \t\r\n");
+  return s.substr(b, e - b + 1);
+}
+
+static void put16(std::vector<uint8_t>& out, uint16_t v)
+{
+  out.push_back(v & 0xFF);
+  out.push_back(v >> 8);
+}
+
+int main(int argc, char* argv[])
+{
+  const char* prefix = "SOUND_TABLE";
+  const char* blobFile = NULL;
+  int i = 1;
+  for (; i + 1 < argc && argv[i][0] == '-'; i += 2)
+  {
+    if (strcmp(argv[i], "-p") == 0)
+      prefix = argv[i + 1];
+    else if (strcmp(argv[i], "-b") == 0)
+      blobFile = argv[i + 1];
+    else
+      break;
+  }
+  if (i + 1 != argc || strlen(argv[i]) == 0 || strlen(argv[i]) > 31)
+  {
+    fprintf(stderr, "usage: %s [-p prefix] [-b file.bin] table_name < names.txt > index.h\n", argv[0]);
+    return 2;
+  }
+  std::string table = argv[i];
+
+  std::vector<Sound> sounds;
+  int16_t count = 0;
+  char line[256];
+  while (fgets(line, sizeof(line), stdin) != NULL)
+  {
+    std::string name = trim(line);
+    ++count;
+    if (name.empty())
+      continue;
+    Sound s;
+    s.name = name;
+    s.entry.hash = EasyVRSoundIndex::hash(name.c_str());
+    s.entry.index = count;
+    sounds.push_back(s);
+  }
+  std::stable_sort(sounds.begin(), sounds.end());
+  bool ok = true;
+  for (size_t k = 1; k < sounds.size(); ++k)
+  {
+    if (sounds[k].entry.hash == sounds[k - 1].entry.hash)
+    {
+      fprintf(stderr, "error: \"%s\" and \"%s\" have the same hash 0x%04X, rename one\n",
+        sounds[k - 1].name.c_str(), sounds[k].name.c_str(), sounds[k].entry.hash);
+      ok = false;
+    }
+  }
+  if (!ok)
+    return 1;
+
+  std::vector<uint8_t> blob;
+  blob.push_back('S');
+  blob.push_back('X');
+  blob.push_back(1);
+  blob.push_back((uint8_t)table.size());
+  blob.insert(blob.end(), table.begin(), table.end());
+  put16(blob, count);
+  put16(blob, (uint16_t)sounds.size());
+  for (size_t k = 0; k < sounds.size(); ++k)
+  {
+    put16(blob, sounds[k].entry.hash);
+    put16(blob, sounds[k].entry.index);
+  }
+
+  // check the result with the same code that will read it
+  EasyVRSoundIndex index;
+  if (!index.begin(blob.data(), (uint16_t)blob.size()))
+  {
+    fprintf(stderr, "error: invalid blob\n");
+    return 1;
+  }
+  for (size_t k = 0; k < sounds.size(); ++k)
+  {
+    if (index.find(sounds[k].name.c_str()) != sounds[k].entry.index)
+    {
+      fprintf(stderr, "error: lookup of \"%s\" failed\n", sounds[k].name.c_str());
+      return 1;
+    }
+  }
+
+  if (blobFile != NULL)
+  {
+    FILE* f = fopen(blobFile, "wb");
+    if (f == NULL || fwrite(blob.data(), 1, blob.size(), f) != blob.size())
+    {
+      perror(blobFile);
+      return 1;
+    }
+    fclose(f);
+  }
+
+  printf("// Sound index for table \"%s\", generated by SoundIndexGen: do not edit.\n\n", table.c_str());
+  printf("#pragma once\n\n#include \"EasyVRSoundIndex.h\"\n\n");
+  printf("#define %s_NAME   \"%s\"\n", prefix, table.c_str());
+  printf("#define %s_COUNT  %d\n", prefix, count);
+  printf("#define %s_SIZE   %u\n\n", prefix, (unsigned)sounds.size());
+  printf("static const EasyVRSoundEntry %s_INDEX[%s_SIZE] PROGMEM =\n{\n", prefix, prefix);
+  for (size_t k = 0; k < sounds.size(); ++k)
+    printf("  { 0x%04X, %3d }, // %s\n", sounds[k].entry.hash, sounds[k].entry.index, sounds[k].name.c_str());
+  printf("};\n");
+  return 0;
+}
@@ -24,14 +24,22 @@ int EASYVR_TOKEN_TIMEOUT = 1500;
 
 void EasyVR::send(uint8_t c)
 {
+  if (_t != NULL)
+  {
+    _t->write(c, 1);
+    return;
+  }
   delay(1);
   _s->write(c);
 }
 
 void EasyVR::sendCmd(uint8_t c)
 {
-  _s->flush();
-  while (_s->available() > 0) _s->read();
+  if (_s != NULL)
+    _s->flush();
+  while (available() > 0) read();
+  _recog = RECOG_NONE;
+  _recognizing = false;
   send(c);
 }
 
@@ -42,35 +50,184 @@ void EasyVR::sendArg(int8_t c)
 
 inline void EasyVR::sendGroup(int8_t c)
 {
-  send(c + ARG_ZERO);
+  uint8_t t = 0;
   if (c != _group)
   {
     _group = c;
     // worst case time to cache a full group in memory
     if (_id >= EASYVR3PLUS)
-      delay(79);
+      t = 79;
     else if (_id >= EASYVR3)
-      delay(39);
+      t = 39;
     else
-      delay(19);
+      t = 19;
+  }
+  if (_t != NULL)
+  {
+    _t->write(c + ARG_ZERO, t + 1);
+    return;
+  }
+  send(c + ARG_ZERO);
+  if (t != 0)
+    delay(t);
+}
+
+void EasyVR::sendRaw(uint8_t c)
+{
+  // immediate write, without pauses
+  if (_t != NULL)
+  {
+    _t->write(c, 0);
+    _t->commit();
   }
+  else
+    _s->write(c);
+}
+
+void EasyVR::commit()
+{
+  if (_t != NULL)
+    _t->commit();
+}
+
+int EasyVR::available()
+{
+  return _t != NULL ? _t->available() : _s->available();
+}
+
+int EasyVR::read()
+{
+  return _t != NULL ? _t->read() : _s->read();
 }
 
-int EasyVR::recv(int16_t timeout) // negative means forever
+int EasyVR::recv(int16_t timeout, uint16_t* elapsed) // negative means forever
 {
-  while (timeout != 0 && _s->available() == 0)
+  commit();
+  unsigned long start = millis();
+  while (timeout != 0 && available() == 0)
   {
-    delay(1);
-    if (timeout > 0)
-      --timeout;
+    unsigned long now = millis();
+    if (_t != NULL && _t->sending())
+      start = now; // count from the end of transmission
+    else if (timeout > 0 && now - start >= (unsigned long)timeout)
+      break;
+    if (_t != NULL)
+      _t->wait(timeout > 0 ? timeout - (now - start) : 0xFFFF);
+    else
+      yield();
   }
-  return _s->read();
+  if (elapsed != NULL)
+    *elapsed = millis() - start;
+  return read();
+}
+
+int EasyVR::recvReply(int8_t type)
+{
+  uint16_t elapsed;
+  int rx = recv(getReplyTimeout(type), &elapsed);
+  if (_adaptive && type < ADAPTIVE_CLASSES)
+    learnReply(type, rx, elapsed);
+  return rx;
+}
+
+void EasyVR::learnReply(int8_t type, int rx, uint16_t elapsed)
+{
+  uint16_t limit = _replyTimeout[type];
+  if (limit == 0)
+    limit = type == TIMEOUT_STORAGE ? STORAGE_TIMEOUT : DEF_TIMEOUT;
+
+  uint32_t t;
+  if (rx < 0)
+  {
+    // no reply, back off
+    t = _learned[type] != 0 ? _learned[type] * 2UL : limit;
+  }
+  else
+  {
+    // same estimator as TCP retransmission timeouts (RFC 6298)
+    if (elapsed > 0x1FFF)
+      elapsed = 0x1FFF; // keep _srtt (ms * 8) within 16 bits
+    if (_srtt[type] == 0)
+    {
+      _srtt[type] = elapsed << 3;
+      _rttvar[type] = elapsed << 1;
+    }
+    else
+    {
+      int16_t err = elapsed - (_srtt[type] >> 3);
+      _srtt[type] += err;
+      if (err < 0)
+        err = -err;
+      _rttvar[type] += err - (_rttvar[type] >> 2);
+    }
+    t = 2UL * ((_srtt[type] >> 3) + _rttvar[type]);
+    if (t < ADAPTIVE_MIN)
+      t = ADAPTIVE_MIN;
+  }
+  _learned[type] = t < limit ? t : limit;
+}
+
+void EasyVR::setReplyTimeout(int8_t type, uint16_t ms)
+{
+  if ((uint8_t)type > TIMEOUT_TOKEN)
+    return;
+  _replyTimeout[type] = ms < MAX_TIMEOUT ? ms : (uint16_t)MAX_TIMEOUT;
+}
+
+uint16_t EasyVR::getReplyTimeout(int8_t type)
+{
+  if ((uint8_t)type > TIMEOUT_TOKEN)
+    type = TIMEOUT_DEFAULT;
+  int32_t t = _replyTimeout[type];
+  if (t == 0)
+  {
+    switch (type)
+    {
+    case TIMEOUT_STORAGE: t = STORAGE_TIMEOUT; break;
+    case TIMEOUT_WAKE: t = WAKE_TIMEOUT; break;
+    case TIMEOUT_PLAY: t = PLAY_TIMEOUT; break;
+    case TIMEOUT_TOKEN: t = TOKEN_TIMEOUT; break;
+    default: t = DEF_TIMEOUT; break;
+    }
+    // the static defaults can be changed by the application
+    if (t > MAX_TIMEOUT)
+      t = MAX_TIMEOUT;
+  }
+  if (_adaptive && type < ADAPTIVE_CLASSES && _learned[type] != 0 && _learned[type] < t)
+    t = _learned[type];
+  return t;
+}
+
+void EasyVR::resetReplyTimeouts()
+{
+  memset(_replyTimeout, 0, sizeof(_replyTimeout));
+  memset(_learned, 0, sizeof(_learned));
+  memset(_srtt, 0, sizeof(_srtt));
+  memset(_rttvar, 0, sizeof(_rttvar));
+}
+
+bool EasyVR::waitSuccess(uint32_t timeout)
+{
+  unsigned long start = millis();
+  uint32_t elapsed = 0;
+  while (available() == 0 && elapsed < timeout)
+  {
+    if (_progress != NULL)
+      _progress(elapsed);
+    else if (_t == NULL)
+      yield();
+    if (_t != NULL)
+      _t->wait(10); // still call the handler often enough
+    elapsed = millis() - start;
+  }
+  _elapsed = elapsed;
+  return read() == STS_SUCCESS;
 }
 
 bool EasyVR::recvArg(int8_t& c)
 {
   send(ARG_ACK);
-  int r = recv(DEF_TIMEOUT);
+  int r = recvReply(TIMEOUT_DEFAULT);
   c = r - ARG_ZERO;
   return r >= ARG_MIN && r <= ARG_MAX;
 }
@@ -146,16 +303,87 @@ void EasyVR::readStatus(int8_t rx)
   _value = 0;
 }
 
+void EasyVR::sendLabel(const char* name)
+{
+  // count characters that fit in 31 encoded units (digits take two)
+  int8_t len = 0;
+  const char* end;
+  for (end = name; *end != 0; ++end)
+  {
+    int8_t n = isdigit(*end) ? 2 : 1;
+    if (len + n > 31)
+      break;
+    len += n;
+  }
+  _status.b._truncated = (*end != 0);
+
+  sendArg(len);
+  for ( ; name < end; ++name)
+  {
+    char c = *name;
+    if (isdigit(c))
+    {
+      send('^');
+      sendArg(c - '0');
+    }
+    else if (isalpha(c))
+    {
+      send(c & ~0x20); // to uppercase
+    }
+    else
+    {
+      send('_');
+    }
+  }
+}
+
+bool EasyVR::recvLabel(char* name, uint8_t size)
+{
+  _status.b._truncated = false;
+  char* last = name + size - 1; // room for terminator
+  bool ok = false;
+  int8_t rx;
+  if (!recvArg(rx))
+    goto END;
+  for (int8_t len = (rx == -1 ? 32 : rx); len > 0; --len)
+  {
+    if (!recvArg(rx))
+      goto END;
+    char c = ARG_ZERO + rx;
+    if (c == '^')
+    {
+      if (!recvArg(rx))
+        goto END;
+      c = '0' + rx;
+      --len;
+    }
+    if (name < last)
+      *name++ = c;
+    else
+      _status.b._truncated = true; // keep reading to stay in sync
+  }
+  ok = true;
+END:
+  *name = 0;
+  return ok;
+}
+
 /*****************************************************************************/
 
 bool EasyVR::detect()
 {
+  // an awake module replies at once, wait longer only if needed
+  uint16_t timeout = getReplyTimeout(TIMEOUT_WAKE);
   uint8_t i;
   for (i = 0; i < 5; ++i)
   {
     sendCmd(CMD_BREAK);
 
-    if (recv(WAKE_TIMEOUT) == STS_SUCCESS)
+    // never zero (that would not wait at all), even with a short timeout
+    uint16_t t = timeout >> (4 - i);
+    if (t < DETECT_MIN)
+      t = DETECT_MIN;
+    if (recv(t) == STS_SUCCESS)
       return true;
   }
   return false;
@@ -165,7 +393,7 @@ bool EasyVR::stop()
 {
   sendCmd(CMD_BREAK);
 
-  uint8_t rx = recv(STORAGE_TIMEOUT);
+  uint8_t rx = recvReply(TIMEOUT_STORAGE);
   if (rx == STS_INTERR || rx == STS_SUCCESS)
     return true;
   return false;
@@ -176,7 +404,7 @@ bool EasyVR::sleep(int8_t mode)
   sendCmd(CMD_SLEEP);
   sendArg(mode);
 
-  if (recv(DEF_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_SUCCESS)
     return true;
   return false;
 }
@@ -184,7 +412,7 @@ bool EasyVR::sleep(int8_t mode)
 int8_t EasyVR::getID()
 {
   sendCmd(CMD_ID);
-  if (recv(DEF_TIMEOUT) == STS_ID)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_ID)
   {
     if (recvArg(_id))
       return _id;
@@ -193,12 +421,26 @@ int8_t EasyVR::getID()
   return _id;
 }
 
+int8_t EasyVR::moduleId()
+{
+  return _id >= 0 ? _id : getID();
+}
+
+bool EasyVR::restoreIdentity(uint16_t stamp)
+{
+  int8_t id = stamp & 0xFF;
+  if (id < 0 || (stamp >> 8) != (uint8_t)(id ^ IDENTITY_CHECK))
+    return false;
+  _id = id;
+  return true;
+}
+
 bool EasyVR::setLanguage(int8_t lang)
 {        
   sendCmd(CMD_LANGUAGE);
   sendArg(lang);
 
-  if (recv(DEF_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_SUCCESS)
     return true;
   return false;
 }
@@ -208,7 +450,7 @@ bool EasyVR::setTimeout(int8_t seconds)
   sendCmd(CMD_TIMEOUT);
   sendArg(seconds);
 
-  if (recv(DEF_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_SUCCESS)
     return true;
   return false;
 }
@@ -219,7 +461,7 @@ bool EasyVR::setMicDistance(int8_t dist)
   sendArg(-1);
   sendArg(dist);
 
-  if (recv(DEF_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_SUCCESS)
     return true;
   return false;
 }
@@ -229,7 +471,7 @@ bool EasyVR::setKnob(int8_t knob)
   sendCmd(CMD_KNOB);
   sendArg(knob);
 
-  if (recv(DEF_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_SUCCESS)
     return true;
   return false;
 }
@@ -240,7 +482,7 @@ bool EasyVR::setTrailingSilence(int8_t dur)
   sendArg(-1);
   sendArg(dur);
 
-  if (recv(DEF_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_SUCCESS)
     return true;
   return false;
 }
@@ -250,7 +492,7 @@ bool EasyVR::setLevel(int8_t level)
   sendCmd(CMD_LEVEL);
   sendArg(level);
 
-  if (recv(DEF_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_SUCCESS)
     return true;
   return false;
 }
@@ -261,7 +503,7 @@ bool EasyVR::setCommandLatency(int8_t mode)
   sendArg(-1);
   sendArg(mode);
 
-  if (recv(DEF_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_SUCCESS)
     return true;
   return false;
 }
@@ -278,21 +520,94 @@ bool EasyVR::setDelay(uint16_t millis)
   else
     return false;
 
-  if (recv(DEF_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_SUCCESS)
     return true;
   return false;
 }
 
+int16_t EasyVR::tuneDelay(uint8_t probes, uint32_t* latency)
+{
+  static const uint8_t delays[] = { 0, 1, 2, 5, 10, 20, 50, 100 };
+
+  if (probes == 0)
+    probes = 1;
+  int8_t id = getID();
+  if (id < 0)
+    return -1;
+  for (uint8_t i = 0; i < sizeof(delays); ++i)
+  {
+    if (!setDelay(delays[i]))
+    {
+      if (!detect())
+        return -1;
+      continue;
+    }
+    uint32_t total = 0;
+    uint8_t n;
+    for (n = 0; n < probes; ++n)
+    {
+      unsigned long t = micros();
+      if (getID() != id)
+        break;
+      total += micros() - t;
+    }
+    if (n == probes)
+    {
+      if (latency != NULL)
+        *latency = total / probes;
+      return delays[i];
+    }
+    detect(); // discard late replies
+  }
+  return -1;
+}
+
 bool EasyVR::changeBaudrate(int8_t baud)
 {
   sendCmd(CMD_BAUDRATE);
   sendArg(baud);
 
-  if (recv(DEF_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_SUCCESS)
     return true;
   return false;
 }
 
+int8_t EasyVR::negotiateBaudrate(EasyVRPortHandler reopen, int8_t current)
+{
+  static const int8_t rates[] = { B115200, B57600, B38400, B19200 };
+
+  // the id read at the new speed must match the one read before switching
+  int8_t id = moduleId();
+  if (id < 0)
+    return -1;
+  for (uint8_t i = 0; i < sizeof(rates); ++i)
+  {
+    int8_t baud = rates[i];
+    if (baud >= current)
+      break; // not faster
+    if (!changeBaudrate(baud))
+    {
+      if (!detect())
+        return -1;
+      continue;
+    }
+    // the reply is sent before switching, let the module settle
+    delay(5);
+    if (reopen(getBaudrateBps(baud)))
+    {
+      if (detect() && getID() == id)
+        return baud;
+      // rollback, the module may still understand this command
+      changeBaudrate(current);
+      delay(5);
+    }
+    if (!reopen(getBaudrateBps(current)) || !detect())
+      return -1;
+    _id = id; // may have been garbled at the faster speed
+  }
+  return current;
+}
+
 
 bool EasyVR::addCommand(int8_t group, int8_t index)
 {
@@ -300,7 +615,7 @@ bool EasyVR::addCommand(int8_t group, int8_t index)
   sendGroup(group);
   sendArg(index);
 
-  int rx = recv(STORAGE_TIMEOUT);
+  int rx = recvReply(TIMEOUT_STORAGE);
   if (rx == STS_SUCCESS)
     return true;
   _status.v = 0;
@@ -315,7 +630,7 @@ bool EasyVR::removeCommand(int8_t group, int8_t index)
   sendGroup(group);
   sendArg(index);
 
-  if (recv(STORAGE_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_STORAGE) == STS_SUCCESS)
     return true;
   return false;
 }
@@ -325,35 +640,9 @@ bool EasyVR::setCommandLabel(int8_t group, int8_t index, const char* name)
   sendCmd(CMD_NAME_SD);
   sendGroup(group);
   sendArg(index);
-  
-  int8_t len = 31;
-  for (const char* p = name; *p != 0 && len > 0; ++p, --len)
-  {
-    if (isdigit(*p))
-      --len;
-  }
-  len = 31 - len;
-  
-  sendArg(len);
-  for (int8_t i = 0; i < len; ++i)
-  {
-    char c = name[i];
-    if (isdigit(c))
-    {
-      send('^');
-      sendArg(c - '0');
-    }
-    else if (isalpha(c))
-    {
-      send(c & ~0x20); // to uppercase
-    }
-    else
-    {
-      send('_');
-    }
-  }
+  sendLabel(name);
 
-  if (recv(STORAGE_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_STORAGE) == STS_SUCCESS)
     return true;
   return false;
 }
@@ -364,7 +653,7 @@ bool EasyVR::eraseCommand(int8_t group, int8_t index)
   sendGroup(group);
   sendArg(index);
 
-  if (recv(STORAGE_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_STORAGE) == STS_SUCCESS)
     return true;
   return false;
 }
@@ -374,7 +663,7 @@ bool EasyVR::getGroupMask(uint32_t& mask)
 {
   sendCmd(CMD_MASK_SD);
 
-  if (recv(DEF_TIMEOUT) == STS_MASK)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_MASK)
   {
     int8_t rx;
     mask = 0;
@@ -397,7 +686,7 @@ int8_t EasyVR::getCommandCount(int8_t group)
   sendCmd(CMD_COUNT_SD);
   sendArg(group);
 
-  if (recv(DEF_TIMEOUT) == STS_COUNT)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_COUNT)
   {
     int8_t rx;
     if (recvArg(rx))
@@ -408,13 +697,13 @@ int8_t EasyVR::getCommandCount(int8_t group)
   return -1;
 }
 
-bool EasyVR::dumpCommand(int8_t group, int8_t index, char* name, uint8_t& training)
+bool EasyVR::dumpCommand(int8_t group, int8_t index, char* name, uint8_t& training, uint8_t size)
 {
   sendCmd(CMD_DUMP_SD);
   sendGroup(group);
   sendArg(index);
 
-  if (recv(DEF_TIMEOUT) != STS_DATA)
+  if (recvReply(TIMEOUT_DEFAULT) != STS_DATA)
     return false;
   
   int8_t rx;
@@ -433,27 +722,7 @@ bool EasyVR::dumpCommand(int8_t group, int8_t index, char* name, uint8_t& traini
     return false;
   _value = rx;
 
-  if (!recvArg(rx))
-    return false;
-  int8_t len = rx == -1 ? 32 : rx;
-  for ( ; len > 0; --len, ++name)
-  {
-    if (!recvArg(rx))
-      return false;
-    if (rx == '^' - ARG_ZERO)
-    {
-      if (!recvArg(rx))
-        return false;
-      *name = '0' + rx;
-      --len;
-    }
-    else
-    {
-      *name = ARG_ZERO + rx;
-    }
-  }
-  *name = 0;
-  return true;
+  return recvLabel(name, size);
 }
 
 int8_t EasyVR::getGrammarsCount(void)
@@ -461,7 +730,7 @@ int8_t EasyVR::getGrammarsCount(void)
   sendCmd(CMD_DUMP_SI);
   sendArg(-1);
 
-  if (recv(DEF_TIMEOUT) == STS_COUNT)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_COUNT)
   {
     int8_t rx;
     if (recvArg(rx))
@@ -477,7 +746,7 @@ bool EasyVR::dumpGrammar(int8_t grammar, uint8_t& flags, uint8_t& count)
   sendCmd(CMD_DUMP_SI);
   sendArg(grammar);
 
-  if (recv(DEF_TIMEOUT) != STS_GRAMMAR)
+  if (recvReply(TIMEOUT_DEFAULT) != STS_GRAMMAR)
     return false;
   
   int8_t rx;
@@ -491,35 +760,9 @@ bool EasyVR::dumpGrammar(int8_t grammar, uint8_t& flags, uint8_t& count)
   return true;
 }
 
-bool EasyVR::getNextWordLabel(char* name)
+bool EasyVR::getNextWordLabel(char* name, uint8_t size)
 {
-  int8_t count;
-  if (!recvArg(count))
-    return false;
-  if (count == -1)
-    count = 32;
-  
-  for ( ; count > 0; --count, ++name)
-  {
-    int8_t rx;
-    if (!recvArg(rx))
-      return false;
-    
-    if (rx == '^' - ARG_ZERO)
-    {
-      if (!recvArg(rx))
-        return false;
-      
-      *name = '0' + rx;
-      --count;
-    }
-    else
-    {
-      *name = ARG_ZERO + rx;
-    }
-  }
-  *name = 0;
-  return true;
+  return recvLabel(name, size);
 }
 
 void EasyVR::trainCommand(int8_t group, int8_t index)
@@ -527,26 +770,37 @@ void EasyVR::trainCommand(int8_t group, int8_t index)
   sendCmd(CMD_TRAIN_SD);
   sendGroup(group);
   sendArg(index);
+  commit();
 }
 
 void EasyVR::recognizeCommand(int8_t group)
 {
   sendCmd(CMD_RECOG_SD);
   sendArg(group);
+  commit();
+  _recog = group;
+  _recognizing = true;
 }
 
 void EasyVR::recognizeWord(int8_t wordset)
 {
   sendCmd(CMD_RECOG_SI);
   sendArg(wordset);
+  commit();
+  _recog = wordset + WORD_TARGET;
+  _recognizing = true;
 }
 
 bool EasyVR::hasFinished()
 {
+  if (_t != NULL && _t->sending())
+    return false;
+
   int8_t rx = recv(NO_TIMEOUT);
   if (rx < 0)
     return false;
   
+  _recognizing = false;
   readStatus(rx);
   return true;
 }
@@ -557,7 +811,7 @@ bool EasyVR::setPinOutput(int8_t pin, int8_t config)
   sendArg(pin);
   sendArg(config);
 
-  if (recv(DEF_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_SUCCESS)
     return true;
   return false;
 }
@@ -568,7 +822,7 @@ int8_t EasyVR::getPinInput(int8_t pin, int8_t config)
   sendArg(pin);
   sendArg(config);
 
-  if (recv(DEF_TIMEOUT) == STS_PIN)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_PIN)
   {
     int8_t rx;
     if (recvArg(rx))
@@ -577,6 +831,34 @@ int8_t EasyVR::getPinInput(int8_t pin, int8_t config)
   return -1;
 }
 
+bool EasyVR::setPinOutputs(uint8_t pins, uint8_t levels)
+{
+  for (int8_t pin = IO1; pin <= IO6; ++pin, pins >>= 1, levels >>= 1)
+  {
+    if (!(pins & 1))
+      continue;
+    if (!setPinOutput(pin, (levels & 1) ? OUTPUT_HIGH : OUTPUT_LOW))
+      return false;
+  }
+  return true;
+}
+
+int8_t EasyVR::getPinInputs(uint8_t pins, int8_t config)
+{
+  int8_t values = 0;
+  for (int8_t pin = IO1; pin <= IO6; ++pin, pins >>= 1)
+  {
+    if (!(pins & 1))
+      continue;
+    int8_t rx = getPinInput(pin, config);
+    if (rx < 0)
+      return -1;
+    if (rx != 0)
+      values |= 1 << (pin - IO1);
+  }
+  return values;
+}
+
 bool EasyVR::playPhoneTone(int8_t tone, uint8_t duration)
 {
   sendCmd(CMD_PLAY_DTMF);
@@ -584,11 +866,20 @@ bool EasyVR::playPhoneTone(int8_t tone, uint8_t duration)
   sendArg(tone);
   sendArg(duration - 1);
 
-  if (recv((tone < 0 ? duration * 1000 : duration * 40) + DEF_TIMEOUT) == STS_SUCCESS)
+  if (recv((tone < 0 ? duration * 1000 : duration * 40) + getReplyTimeout(TIMEOUT_DEFAULT)) == STS_SUCCESS)
     return true;
   return false;
 }
 
+void EasyVR::playPhoneToneAsync(int8_t tone, uint8_t duration)
+{
+  sendCmd(CMD_PLAY_DTMF);
+  sendArg(-1); // distinguish DTMF from SX
+  sendArg(tone);
+  sendArg(duration - 1);
+  commit();
+}
+
 bool EasyVR::playSound(int16_t index, int8_t volume)
 {
   sendCmd(CMD_PLAY_SX);
@@ -596,7 +887,7 @@ bool EasyVR::playSound(int16_t index, int8_t volume)
   sendArg(index & 0x1F);
   sendArg(volume);
 
-  if (recv(PLAY_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_PLAY) == STS_SUCCESS)
     return true;
   return false;
 }
@@ -607,6 +898,7 @@ void EasyVR::playSoundAsync(int16_t index, int8_t volume)
   sendArg((index >> 5) & 0x1F);
   sendArg(index & 0x1F);
   sendArg(volume);
+  commit();
 }
 
 void EasyVR::detectToken(int8_t bits, int8_t rejection, uint16_t timeout)
@@ -618,6 +910,7 @@ void EasyVR::detectToken(int8_t bits, int8_t rejection, uint16_t timeout)
     timeout = (timeout * 2 + 53)/ 55; // approx / 27.46 - err < 0.15%
   sendArg((timeout >> 5) & 0x1F);
   sendArg(timeout & 0x1F);
+  commit();
 }
 
 bool EasyVR::sendToken(int8_t bits, uint8_t token)
@@ -629,7 +922,7 @@ bool EasyVR::sendToken(int8_t bits, uint8_t token)
   sendArg(0);
   sendArg(0);
 
-  if (recv(TOKEN_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_TOKEN) == STS_SUCCESS)
     return true;
   return false;
 }
@@ -642,6 +935,7 @@ void EasyVR::sendTokenAsync(int8_t bits, uint8_t token)
   sendArg(token & 0x1F);
   sendArg(0);
   sendArg(0);
+  commit();
 }
 
 bool EasyVR::embedToken(int8_t bits, uint8_t token, uint16_t delay)
@@ -656,16 +950,16 @@ bool EasyVR::embedToken(int8_t bits, uint8_t token, uint16_t delay)
   sendArg((delay >> 5) & 0x1F);
   sendArg(delay & 0x1F);
 
-  if (recv(DEF_TIMEOUT) == STS_SUCCESS)
+  if (recvReply(TIMEOUT_DEFAULT) == STS_SUCCESS)
     return true;
   return false;
 }
 
-bool EasyVR::dumpSoundTable(char* name, int16_t& count)
+bool EasyVR::dumpSoundTable(char* name, int16_t& count, uint8_t size)
 {
   sendCmd(CMD_DUMP_SX);
 
-  if (recv(DEF_TIMEOUT) != STS_TABLE_SX)
+  if (recvReply(TIMEOUT_DEFAULT) != STS_TABLE_SX)
     return false;
   
   int8_t rx;
@@ -676,71 +970,38 @@ bool EasyVR::dumpSoundTable(char* name, int16_t& count)
     return false;
   count |= rx;
   
-  if (!recvArg(rx))
-    return false;
-  int len = rx;
-  for (int8_t i = 0, k = 0; i < len; ++i, ++k)
-  {
-    if (!recvArg(rx))
-      return false;
-    if (rx == '^' - ARG_ZERO)
-    {
-      if (!recvArg(rx))
-        return false;
-      ++i;
-      name[k] = '0' + rx;
-    }
-    else
-    {
-      name[k] = ARG_ZERO + rx;
-    }
-  }
-  name[len] = 0;
-  return true;
+  return recvLabel(name, size);
 }
 
 bool EasyVR::resetAll(bool wait)
 {
-  int timeout = 40; // seconds
-  if (getID() >= EASYVR3)
-    timeout = 5;
+  uint32_t timeout = 40000; // ms
+  if (moduleId() >= EASYVR3)
+    timeout = 5000;
 
   sendCmd(CMD_RESETALL);
   sendArg('R' - ARG_ZERO);
 
+  commit();
   if (!wait)
     return true;
 
-  while (timeout != 0 && _s->available() == 0)
-  {
-    delay(1000);
-    --timeout;
-  }
-  if (_s->read() == STS_SUCCESS)
-    return true;
-  return false;
+  return waitSuccess(timeout);
 }
 
 bool EasyVR::resetCommands(bool wait)
 {
-  if (getID() >= EASYVR3_1)
+  if (moduleId() >= EASYVR3_1)
     return resetAll(wait); // map to reset all for older firmwares
 
   sendCmd(CMD_RESET_SD);
   sendArg('D' - ARG_ZERO);
 
+  commit();
   if (!wait)
     return true;
 
-  int timeout = 5; // seconds
-  while (timeout != 0 && _s->available() == 0)
-  {
-    delay(1000);
-    --timeout;
-  }
-  if (_s->read() == STS_SUCCESS)
-    return true;
-  return false;
+  return waitSuccess(5000);
 }
 
 bool EasyVR::resetMessages(bool wait)
@@ -748,18 +1009,11 @@ bool EasyVR::resetMessages(bool wait)
   sendCmd(CMD_RESET_RP);
   sendArg('M' - ARG_ZERO);
 
+  commit();
   if (!wait)
     return true;
 
-  int timeout = 15; // seconds
-  while (timeout != 0 && _s->available() == 0)
-  {
-    delay(1000);
-    --timeout;
-  }
-  if (_s->read() == STS_SUCCESS)
-    return true;
-  return false;
+  return waitSuccess(15000);
 }
 
 bool EasyVR::checkMessages()
@@ -768,7 +1022,7 @@ bool EasyVR::checkMessages()
   sendArg(-1);
   sendArg(0);
 
-  int rx = recv(STORAGE_TIMEOUT);
+  int rx = recvReply(TIMEOUT_STORAGE);
   readStatus(rx);
   return (_status.v == 0);
 }
@@ -779,18 +1033,11 @@ bool EasyVR::fixMessages(bool wait)
   sendArg(-1);
   sendArg(1);
 
+  commit();
   if (!wait)
     return true;
 
-  int timeout = 25; // seconds
-  while (timeout != 0 && _s->available() == 0)
-  {
-    delay(1000);
-    --timeout;
-  }
-  if (_s->read() == STS_SUCCESS)
-    return true;
-  return false;
+  return waitSuccess(25000);
 }
 
 void EasyVR::recordMessageAsync(int8_t index, int8_t bits, int8_t timeout)
@@ -800,6 +1047,7 @@ void EasyVR::recordMessageAsync(int8_t index, int8_t bits, int8_t timeout)
   sendArg(index);
   sendArg(bits);
   sendArg(timeout);
+  commit();
 }
 
 void EasyVR::playMessageAsync(int8_t index, int8_t speed, int8_t atten)
@@ -808,6 +1056,7 @@ void EasyVR::playMessageAsync(int8_t index, int8_t speed, int8_t atten)
   sendArg(-1);
   sendArg(index);
   sendArg((speed << 2) | (atten & 3));
+  commit();
 }
 
 void EasyVR::eraseMessageAsync(int8_t index)
@@ -815,6 +1064,7 @@ void EasyVR::eraseMessageAsync(int8_t index)
   sendCmd(CMD_ERASE_RP);
   sendArg(-1);
   sendArg(index);
+  commit();
 }
 
 bool EasyVR::dumpMessage(int8_t index, int8_t& type, int32_t& length)
@@ -823,7 +1073,7 @@ bool EasyVR::dumpMessage(int8_t index, int8_t& type, int32_t& length)
   sendArg(-1);
   sendArg(index);
 
-  int sts = recv(STORAGE_TIMEOUT);
+  int sts = recvReply(TIMEOUT_STORAGE);
   if (sts != STS_MESSAGE)
   {
     readStatus(sts);
@@ -833,6 +1083,7 @@ bool EasyVR::dumpMessage(int8_t index, int8_t& type, int32_t& length)
   // if communication should fail
   _status.v = 0;
   _status.b._error = true;
+  _value = 0;
 
   if (!recvArg(type))
     return false;
@@ -864,7 +1115,7 @@ bool EasyVR::realtimeLipsync(int16_t threshold, uint8_t timeout)
   sendArg((timeout >> 4) & 0x0F);
   sendArg(timeout & 0x0F);
 
-  int sts = recv(DEF_TIMEOUT);
+  int sts = recvReply(TIMEOUT_DEFAULT);
   if (sts != STS_LIPSYNC)
   {
     readStatus(sts);
@@ -876,7 +1127,7 @@ bool EasyVR::realtimeLipsync(int16_t threshold, uint8_t timeout)
 bool EasyVR::fetchMouthPosition(int8_t& value)
 {
   send(ARG_ACK);
-  int rx = recv(DEF_TIMEOUT);
+  int rx = recvReply(TIMEOUT_DEFAULT);
   if (rx >= ARG_MIN && rx <= ARG_MAX)
   {
     value = rx - ARG_ZERO;
@@ -888,6 +1139,31 @@ bool EasyVR::fetchMouthPosition(int8_t& value)
   return false;
 }
 
+void EasyVR::requestMouthPosition()
+{
+  send(ARG_ACK);
+  commit();
+}
+
+bool EasyVR::hasMouthPosition(int8_t& value)
+{
+  if (_t != NULL && _t->sending())
+    return false;
+
+  int rx = recv(NO_TIMEOUT);
+  if (rx < 0)
+    return false;
+  if (rx >= ARG_MIN && rx <= ARG_MAX)
+  {
+    value = rx - ARG_ZERO;
+    return true;
+  }
+  // finished
+  readStatus(rx);
+  value = -1;
+  return true;
+}
+
 // Service functions
 
 bool EasyVR::exportCommand(int8_t group, int8_t index, uint8_t* data)
@@ -897,7 +1173,7 @@ bool EasyVR::exportCommand(int8_t group, int8_t index, uint8_t* data)
   sendGroup(group);
   sendArg(index);
   
-  if (recv(STORAGE_TIMEOUT) != STS_SERVICE)
+  if (recvReply(TIMEOUT_STORAGE) != STS_SERVICE)
     return false;
   
   int8_t rx;
@@ -916,6 +1192,59 @@ bool EasyVR::exportCommand(int8_t group, int8_t index, uint8_t* data)
   return true;
 }
 
+void EasyVR::exportCommandAsync(int8_t group, int8_t index)
+{
+  sendCmd(CMD_SERVICE);
+  sendArg(SVC_EXPORT_SD - ARG_ZERO);
+  sendGroup(group);
+  sendArg(index);
+  commit();
+}
+
+int8_t EasyVR::hasExportedCommand(uint8_t* data, int16_t& progress)
+{
+  if (_t != NULL && _t->sending())
+    return 0;
+
+  int rx = recv(NO_TIMEOUT);
+  if (rx < 0)
+    return 0;
+  if (progress == 0)
+  {
+    if (rx != STS_SERVICE)
+      return -1;
+  }
+  else
+  {
+    if (rx < ARG_MIN || rx > ARG_MAX)
+      return -1;
+    rx -= ARG_ZERO;
+    if (progress == 1)
+    {
+      if (rx != SVC_DUMP_SD - ARG_ZERO)
+        return -1;
+    }
+    else
+    {
+      // two nibbles per byte, most significant first
+      int16_t i = progress - 2;
+      if (i & 1)
+        data[i >> 1] |= (rx & 0x0F);
+      else
+        data[i >> 1] = (rx << 4) & 0xF0;
+      if (i == 258 * 2 - 1)
+      {
+        ++progress;
+        return 1;
+      }
+    }
+  }
+  ++progress;
+  send(ARG_ACK); // request next argument
+  commit();
+  return 0;
+}
+
 bool EasyVR::importCommand(int8_t group, int8_t index, const uint8_t* data)
 {
   sendCmd(CMD_SERVICE);
@@ -931,7 +1260,7 @@ bool EasyVR::importCommand(int8_t group, int8_t index, const uint8_t* data)
     tx = data[i] & 0x0F;
     sendArg(tx);
   }
-  if (recv(STORAGE_TIMEOUT) != STS_SUCCESS)
+  if (recvReply(TIMEOUT_STORAGE) != STS_SUCCESS)
     return false;
   return true;
 }
@@ -942,6 +1271,7 @@ void EasyVR::verifyCommand(int8_t group, int8_t index)
   sendArg(SVC_VERIFY_SD - ARG_ZERO);
   sendGroup(group);
   sendArg(index);
+  commit();
 }
 
 // Bridge Mode implementation
@@ -963,12 +1293,12 @@ void EasyVR::bridgeLoop(Stream& pcSerial)
         time = millis() + 100;
         continue;
       }
-      _s->write(rx);
+      sendRaw(rx);
       cmd = -1;
       time = millis() + 100;
     }
-    if (_s->available())
-      pcSerial.write(_s->read());
+    if (available())
+      pcSerial.write(read());
   }
 }
 
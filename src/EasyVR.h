@@ -14,6 +14,7 @@ file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
 
 #include <Stream.h>
 #include <stdint.h>
+#include "EasyVRTransport.h"
 
 /*****************************************************************************/
 
@@ -60,13 +61,29 @@ file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
 /** @}
 */
 
+/**
+  Type of the function called to change the speed of the host serial port.
+  @param bps is the new speed in bits per second
+  @retval true if the port has been re-opened successfully
+*/
+typedef bool (*EasyVRPortHandler)(uint32_t bps);
+
+/**
+  Type of the function called repeatedly while waiting for a long operation.
+  @param elapsed is the time in milliseconds since the wait started
+*/
+typedef void (*EasyVRProgressHandler)(uint32_t elapsed);
+
 /**
   An implementation of the %EasyVR communication protocol.
 */
 class EasyVR
 {
+  friend class EasyVRBridge;
+
 protected:
   Stream* _s; // communication interface for the EasyVR module
+  EasyVRTransport* _t; // asynchronous interface (replaces _s if not NULL)
 
   uint8_t _value; // store last result or error code
 
@@ -84,6 +101,7 @@ protected:
       uint16_t _conflict : 1;
       uint16_t _token : 1;
       uint16_t _awakened : 1;
+      uint16_t _truncated : 1;
     }
     b;
   }
@@ -93,9 +111,24 @@ protected:
 
   int8_t _id; // last detected module id (can optimize some functions)
 
+  int8_t _recog; // target of pending recognition (group, or wordset + WORD_TARGET)
+  bool _recognizing; // recognition started and not yet completed
+
+  EasyVRProgressHandler _progress; // called while waiting for long operations
+  uint32_t _elapsed; // duration of last long operation (in ms)
+
+  uint16_t _replyTimeout[5]; // per TimeoutClass (0 = use static default)
+  uint16_t _learned[2]; // adaptive timeouts for default and storage replies
+  uint16_t _srtt[2]; // smoothed reply time (in ms * 8)
+  uint16_t _rttvar[2]; // reply time deviation (in ms * 4)
+  bool _adaptive;
+
   enum // internal constants
   {
       NO_TIMEOUT = 0, INFINITE = -1,
+      RECOG_NONE = -1,
+      ADAPTIVE_CLASSES = 2, ADAPTIVE_MIN = 20, MAX_TIMEOUT = 0x7FFF,
+      IDENTITY_CHECK = 0xA5, DETECT_MIN = 5,
   };
 
   // internal functions
@@ -103,9 +136,19 @@ protected:
   void sendCmd(uint8_t c);
   void sendArg(int8_t c);
   void sendGroup(int8_t c);
-  int recv(int16_t timeout = INFINITE);
+  void sendRaw(uint8_t c);
+  void commit();
+  int available();
+  int read();
+  int recv(int16_t timeout = INFINITE, uint16_t* elapsed = NULL);
+  int recvReply(int8_t type);
+  int8_t moduleId();
+  void learnReply(int8_t type, int rx, uint16_t elapsed);
+  bool waitSuccess(uint32_t timeout);
   bool recvArg(int8_t& c);
   void readStatus(int8_t rx);
+  void sendLabel(const char* name);
+  bool recvLabel(char* name, uint8_t size);
     
 public:
   // overridable
@@ -116,6 +159,15 @@ public:
     TOKEN_TIMEOUT,
     STORAGE_TIMEOUT;
 
+  /** Classes of replies with separate timeouts */
+  enum TimeoutClass
+  {
+    TIMEOUT_DEFAULT,  /**< Most commands (default #DEF_TIMEOUT) */
+    TIMEOUT_STORAGE,  /**< Commands writing to internal storage (default #STORAGE_TIMEOUT) */
+    TIMEOUT_WAKE,     /**< Wake up from sleep (default #WAKE_TIMEOUT) */
+    TIMEOUT_PLAY,     /**< Synchronous playback (default #PLAY_TIMEOUT) */
+    TIMEOUT_TOKEN,    /**< Synchronous SonicNet tokens (default #TOKEN_TIMEOUT) */
+  };
   /** Module identification number (firmware version) */
   enum ModuleId
   {
@@ -147,6 +199,11 @@ public:
     TRIGGER = 0,    /**< The trigger group (shared with built-in trigger word) */
     PASSWORD = 16,  /**< The password group (uses speaker verification technology) */
   };
+  /** Encoding of a recognition target in a single value */
+  enum Target
+  {
+    WORD_TARGET = 0x20, /**< Offset of word sets in a target (groups are below it) */
+  };
   /** Index of built-in word sets */
   enum Wordset
   {
@@ -378,13 +435,66 @@ public:
     and #NewSoftSerial).
     @param s the Stream object to use for communication with the EasyVR module
   */
-  EasyVR(Stream& s) : _s(&s), _value(-1), _group(-1), _id(-1)
+  EasyVR(Stream& s) : _s(&s), _t(NULL), _value(-1), _group(-1), _id(-1), _recog(RECOG_NONE),
+    _recognizing(false), _progress(NULL), _elapsed(0), _adaptive(false)
+  {
+    _status.v = 0;
+    resetReplyTimeouts();
+  };
+  /**
+    Creates an EasyVR object, using an asynchronous communication object
+    implementing the #EasyVRTransport interface (such as an interrupt or DMA
+    driven serial port).
+    Asynchronous functions return as soon as the command has been queued,
+    and #hasFinished() reports completion only after it has been transmitted.
+    @param t the transport object to use for communication with the EasyVR module
+  */
+  EasyVR(EasyVRTransport& t) : _s(NULL), _t(&t), _value(-1), _group(-1), _id(-1), _recog(RECOG_NONE),
+    _recognizing(false), _progress(NULL), _elapsed(0), _adaptive(false)
   {
     _status.v = 0;
+    resetReplyTimeouts();
   };
+  /**
+    Sets the reply timeout of this instance for a class of commands.
+    @param type is one of the values in #TimeoutClass
+    @param ms (0-32767) is the maximum time in milliseconds to wait for a
+    reply (longer values are reduced), or (0) to use the static default
+    (such as #DEF_TIMEOUT)
+  */
+  void setReplyTimeout(int8_t type, uint16_t ms);
+  /**
+    Gets the reply timeout currently in use for a class of commands.
+    @param type is one of the values in #TimeoutClass
+    @retval integer is the timeout in milliseconds, possibly reduced by
+    adaptive timeouts
+  */
+  uint16_t getReplyTimeout(int8_t type);
+  /**
+    Enables adaptive timeouts for default and storage replies (see
+    #TimeoutClass). The reply time is tracked with a smoothed average and
+    deviation, and the timeout is set to twice their sum (at least 20 ms),
+    but not longer than the configured timeout, so that a dead link is
+    detected much sooner. The timeout is doubled after each missing reply.
+    @param enable is true to enable adaptive timeouts
+  */
+  void setAdaptiveTimeouts(bool enable) { _adaptive = enable; }
+  /**
+    Gets the smoothed reply time for a class of commands (only tracked for
+    default and storage replies, when adaptive timeouts are enabled).
+    @param type is one of the values in #TimeoutClass
+    @retval integer is the average reply time in milliseconds
+  */
+  uint16_t getReplyLatency(int8_t type) { return (uint8_t)type < ADAPTIVE_CLASSES ? _srtt[type] >> 3 : 0; }
+  /**
+    Restores the static defaults for all reply timeouts and forgets the
+    reply times learned by adaptive timeouts.
+  */
+  void resetReplyTimeouts();
   /**
     Detects an EasyVR module, waking it from sleep mode and checking
-    it responds correctly.
+    it responds correctly. The first attempts use short timeouts, that
+    grow up to #WAKE_TIMEOUT only if the module does not reply.
     @retval true if a compatible module has been found
   */
   bool detect();
@@ -398,6 +508,27 @@ public:
     @retval integer is one of the values in #ModuleId
   */
   int8_t getID();
+  /**
+    Gets the module identification number, as read by the last call to
+    #getID() or restored by #restoreIdentity(), without querying the module.
+    Functions that depend on the module version use this value when known.
+    @retval integer is one of the values in #ModuleId, (-1) if unknown
+  */
+  int8_t getCachedID() { return _id; }
+  /**
+    Gets the cached module identification with a validity stamp, to be
+    stored in non-volatile memory (for example EEPROM) and passed to
+    #restoreIdentity() on later boots.
+    @retval integer is the stamped identification, (0) if unknown
+  */
+  uint16_t saveIdentity() { return _id >= 0 ? ((uint16_t)(uint8_t)(_id ^ IDENTITY_CHECK) << 8) | _id : 0; }
+  /**
+    Restores the module identification saved with #saveIdentity(), so
+    that it does not need to be read from the module.
+    @param stamp is the value returned by #saveIdentity()
+    @retval true if the stamp is valid and the identification was restored
+  */
+  bool restoreIdentity(uint16_t stamp);
   /**
     Sets the language to use for recognition of built-in words.
     @param lang (0-5) is one of values in #Language
@@ -451,6 +582,22 @@ public:
     @retval true if the operation is successful
   */
   bool setDelay(uint16_t millis);
+  /**
+    Finds and sets the shortest reply delay that works reliably with the
+    current host interface. Candidate delays (0, 1, 2, 5, 10, 20, 50 and 100
+    milliseconds) are tried in increasing order, each with a number of
+    #getID() requests, until one completes all requests without errors.
+    @param probes (1-255) is the number of requests for each candidate (0 is
+    taken as 1)
+    @param latency is an optional variable that holds the average round-trip
+    time in microseconds with the selected delay
+    @retval integer is the selected delay in milliseconds, or (-1) if no
+    candidate works reliably
+    @note The result depends only on the host side, so it can be stored (for
+    example in EEPROM) and passed to #setDelay() on later boots, instead of
+    repeating the procedure.
+  */
+  int16_t tuneDelay(uint8_t probes = 8, uint32_t* latency = NULL);
   /**
     Sets the new communication speed. You need to modify the baudrate of the
     underlying Stream object accordingly, after the function returns successfully.
@@ -458,6 +605,25 @@ public:
     @retval true if the operation is successful
   */
   bool changeBaudrate(int8_t baud);
+  /**
+    Gets the communication speed corresponding to a #Baudrate value.
+    @param baud is one of values in #Baudrate
+    @retval integer is the speed in bits per second
+  */
+  static uint32_t getBaudrateBps(int8_t baud) { return 115200UL / baud; }
+  /**
+    Switches to the fastest communication speed that works reliably. Each
+    value in #Baudrate faster than the current one is tried in turn, starting
+    from the fastest: the host port is re-opened through the callback and the
+    new speed is verified with #detect() and #getID(), that must return the
+    same id as before switching. If verification fails, both sides are
+    brought back to the previous speed.
+    @param reopen is the function that changes the speed of the host port
+    @param current is the #Baudrate value currently in use
+    @retval integer is the #Baudrate value in use when the function returns,
+    or (-1) if communication with the module has been lost
+  */
+  int8_t negotiateBaudrate(EasyVRPortHandler reopen, int8_t current = B9600);
   /**
     Puts the module in sleep mode.
     @param mode is one of values in #WakeMode, optionally combined with one of
@@ -487,6 +653,8 @@ public:
     @param name is a string containing the label to be assigned to the
     specified command
     @retval true if the operation is successful
+    @note Labels are limited to 31 characters, where each digit counts as two.
+    Longer labels are cut and #isTruncated() returns true.
   */
   bool setCommandLabel(int8_t group, int8_t index, const char* name);
   /**
@@ -513,14 +681,16 @@ public:
     Retrieves the name and training data of a custom command.
     @param group (0-16) is the target group, or one of the values in #Groups
     @param index (0-31) is the index of the command within the selected group
-    @param name points to an array of at least 32 characters that holds the
+    @param name points to an array of at least \p size characters that holds the
     command label when the function returns
     @param training is a variable that holds the training count when the
     function returns. Additional information about training is available
     through the functions #isConflict() and #getWord() or #getCommand()
+    @param size is the capacity of the name array (including the terminator),
+    a longer label is cut and #isTruncated() returns true
     @retval true if the operation is successful
   */
-  bool dumpCommand(int8_t group, int8_t index, char* name, uint8_t& training);
+  bool dumpCommand(int8_t group, int8_t index, char* name, uint8_t& training, uint8_t size = 32);
   // custom grammars
   /**
     Gets the total number of grammars available, including built-in and custom.
@@ -541,11 +711,13 @@ public:
   /**
     Retrieves the name of a command contained in a custom grammar.
     It must be called after #dumpGrammar()
-    @param name points to an array of at least 32 characters that holds the
+    @param name points to an array of at least \p size characters that holds the
     command label when the function returns
+    @param size is the capacity of the name array (including the terminator),
+    a longer label is cut and #isTruncated() returns true
     @retval true if the operation is successful
   */
-  bool getNextWordLabel(char* name);
+  bool getNextWordLabel(char* name, uint8_t size = 32);
   // recognition/training
   /**
     Starts training of a custom command. Results are available after
@@ -635,6 +807,37 @@ public:
     protocol
   */
   bool isInvalid() { return _status.b._invalid; }
+  /**
+    Retrieves the truncated label indicator (only valid after a function
+    that sends or receives a label).
+    @retval true if the last label did not fit and has been cut
+  */
+  bool isTruncated() { return _status.b._truncated; }
+  /**
+    Gets the group of the last recognition started with #recognizeCommand().
+    @retval (0-16) is the group of custom commands, (-1) if the last command
+    sent to the module was not a recognition of custom commands
+  */
+  int8_t getRecognitionGroup() { return _recog < WORD_TARGET ? _recog : -1; }
+  /**
+    Tells if a recognition started with #recognizeCommand() or
+    #recognizeWord() is still in progress, that is #hasFinished() has not
+    reported its completion yet and no other command has been sent.
+    @retval true if the module is listening
+  */
+  bool isRecognizing() { return _recognizing; }
+  /**
+    Gets the word set of the last recognition started with #recognizeWord(),
+    or #TRIGGER_SET if the mixed trigger group was used with #recognizeCommand().
+    @retval (0-31) is the built-in word set or custom grammar, (-1) if the
+    last command sent to the module was not a recognition of words
+  */
+  int8_t getRecognitionWordset()
+  {
+    if (_recog >= WORD_TARGET)
+      return _recog - WORD_TARGET;
+    return _recog == TRIGGER ? TRIGGER_SET : -1;
+  }
   // pin I/O functions
   /**
     Configures an I/O pin as an output and sets its value
@@ -653,6 +856,27 @@ public:
     @retval integer is the logical value of the pin
   */
   int8_t getPinInput(int8_t pin, int8_t config);
+  /**
+    Configures several I/O pins as outputs and sets their values, in a
+    single call sequence.
+    @param pins is a bit mask of the pins to set (bit 0 for #IO1, bit 1 for
+    #IO2 and so on)
+    @param levels is a bit mask of the output values, with the same layout
+    (bits set for #OUTPUT_HIGH, cleared for #OUTPUT_LOW)
+    @retval true if the operation is successful for all the pins
+  */
+  bool setPinOutputs(uint8_t pins, uint8_t levels);
+  /**
+    Configures several I/O pins as inputs with the same optional pull-up
+    and reads their values, in a single call sequence.
+    @param pins is a bit mask of the pins to read (bit 0 for #IO1, bit 1 for
+    #IO2 and so on)
+    @param config (2-4) is one of the input values in #PinConfig (#INPUT_HIZ,
+    #INPUT_STRONG, #INPUT_WEAK)
+    @retval integer is a bit mask of the logical values of the pins (with
+    the same layout), or (-1) in case of errors
+  */
+  int8_t getPinInputs(uint8_t pins, int8_t config);
   // sound table functions
   /**
     Starts listening for a SonicNet token. Manually check for
@@ -716,13 +940,15 @@ public:
   bool playSound(int16_t index, int8_t volume);
   /**
     Retrieves the name of the sound table and the number of sounds it contains
-    @param name points to an array of at least 32 characters that holds the
+    @param name points to an array of at least \p size characters that holds the
     sound table label when the function returns
     @param count is a variable that holds the number of sounds when the
     function returns
+    @param size is the capacity of the name array (including the terminator),
+    a longer label is cut and #isTruncated() returns true
     @retval true if the operation is successful
   */
-  bool dumpSoundTable(char* name, int16_t& count);
+  bool dumpSoundTable(char* name, int16_t& count, uint8_t size = 32);
   /**
     Plays a phone tone and waits for completion
     @param tone is the index of the tone (0-9 for digits, 10 for '*' key, 11
@@ -732,6 +958,17 @@ public:
     @retval true if the operation is successful
   */
   bool playPhoneTone(int8_t tone, uint8_t duration);
+  /**
+    Starts playback of a phone tone. Manually check for completion with
+    #hasFinished().
+    @param tone is the index of the tone (0-9 for digits, 10 for '*' key, 11
+    for '#' key and 12-15 for extra keys 'A' to 'D', -1 for the dial tone)
+    @param duration (1-32) is the tone duration in 40 milliseconds units, or
+    in seconds for the dial tone
+    @note The module is busy until playback completes and it cannot
+    accept other commands. You can interrupt playback with #stop().
+  */
+  void playPhoneToneAsync(int8_t tone, uint8_t duration);
   /**
     Empties internal memory for custom commands/groups and messages.
     @param wait specifies whether to wait until the operation is complete (or times out)
@@ -777,6 +1014,19 @@ public:
     accept any other command. The sound table and custom grammars data is not affected.
   */
   bool fixMessages(bool wait = true);
+  /**
+    Sets the function to call while waiting for the completion of reset and
+    fix operations (#resetAll(), #resetCommands(), #resetMessages() and
+    #fixMessages()), for example to feed a watchdog or to report progress.
+    When not set, yield() is called instead.
+    @param handler is the function to call, or NULL to remove it
+  */
+  void setProgressHandler(EasyVRProgressHandler handler) { _progress = handler; }
+  /**
+    Gets the duration of the last reset or fix operation that was waited for.
+    @retval integer is the time in milliseconds until the module replied
+  */
+  uint32_t getElapsed() { return _elapsed; }
   /**
     Starts recording a message. Manually check for completion with #hasFinished().
     @param index (0-31) is the index of the target message slot
@@ -829,6 +1079,18 @@ public:
     @retval true if the operation is successful, false if lip-sync has finished
   */
   bool fetchMouthPosition(int8_t& value);
+  /**
+    Requests the current mouth position during lip-sync, without waiting
+    for the reply. Check for the reply with #hasMouthPosition().
+  */
+  void requestMouthPosition();
+  /**
+    Polls for the reply to #requestMouthPosition().
+    @param value (0-31) is filled in with the current mouth opening position,
+    or (-1) if lip-sync has finished (check #isTimeout() or #getError())
+    @retval true if the reply has been received
+  */
+  bool hasMouthPosition(int8_t& value);
   // service functions
   /**
     Retrieves all internal data associated to a custom command.
@@ -839,6 +1101,25 @@ public:
     @retval true if the operation is successful
   */
   bool exportCommand(int8_t group, int8_t index, uint8_t* data);
+  /**
+    Starts retrieving all internal data associated to a custom command.
+    Receive the data with #hasExportedCommand().
+    @param group (0-16) is the target group, or one of the values in #Groups
+    @param index (0-31) is the index of the command within the selected group
+  */
+  void exportCommandAsync(int8_t group, int8_t index);
+  /**
+    Receives the data requested with #exportCommandAsync(), without waiting.
+    Call this function repeatedly until it returns a non-zero value, and
+    give up if no progress is made for a while (see #getReplyTimeout()).
+    @param data points to an array of at least 258 bytes that holds the
+    command raw data
+    @param progress is a variable that must be set to 0 before the first
+    call, it is updated as data is received (it reaches 518 at the end)
+    @retval (1) if all data has been received, (0) if more data is expected,
+    (-1) if the operation failed
+  */
+  int8_t hasExportedCommand(uint8_t* data, int16_t& progress);
   /**
     Overwrites all internal data associated to a custom command.
     When commands are imported this way, their training should be tested again
@@ -0,0 +1,152 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#include "Arduino.h"
+#include "EasyVRBridge.h"
+
+/*****************************************************************************/
+
+EasyVRBridge::EasyVRBridge(EasyVR& vr, Stream& port) : _vr(vr), _port(port),
+  _window(0), _request(false), _mode(EasyVR::BRIDGE_NONE), _mux(false), _held(false),
+  _forwarded(false), _gap(DEF_IDLE_GAP)
+{
+}
+
+void EasyVRBridge::reply(uint8_t c)
+{
+  _port.write(c);
+  delay(1); // flush not reliable on some core libraries
+  _port.flush();
+}
+
+void EasyVRBridge::begin(uint16_t window)
+{
+  _port.write(0x99);
+  _start = millis();
+  _window = window;
+  _request = false;
+  _mode = EasyVR::BRIDGE_NONE;
+}
+
+int8_t EasyVRBridge::poll()
+{
+  if (_window == 0)
+    return EasyVR::BRIDGE_NONE;
+
+  // same handshake as EasyVR::bridgeRequested()
+  int rx;
+  while ((rx = _port.read()) >= 0)
+  {
+    if (!_request)
+    {
+      if (rx == 0xBB)
+      {
+        reply(0xCC);
+        _request = true;
+      }
+      continue;
+    }
+    _request = false;
+    if (rx == 0xDD)
+    {
+      reply(0xEE);
+      _mode = EasyVR::BRIDGE_NORMAL;
+    }
+    else if (rx == 0xAA)
+    {
+      reply(0xFF);
+      _mode = EasyVR::BRIDGE_BOOT;
+    }
+    else
+      continue;
+    _window = 0;
+    return _mode;
+  }
+  if (millis() - _start >= _window)
+    _window = 0;
+  return EasyVR::BRIDGE_NONE;
+}
+
+void EasyVRBridge::beginMux()
+{
+  _mux = true;
+  _held = false;
+  _replied = true;
+  _escape = false;
+  _forwarded = true;
+  _last = _idle = millis();
+}
+
+bool EasyVRBridge::pollMux()
+{
+  if (!_mux || _held)
+    return _mux;
+
+  unsigned long now = millis();
+  // same escape sequence as EasyVR::bridgeLoop()
+  if (_escape && now - _last >= 100)
+  {
+    _mux = false;
+    return false;
+  }
+  int rx;
+  while ((rx = _port.read()) >= 0)
+  {
+    if (rx == EasyVR::BRIDGE_ESCAPE_CHAR && now - _last >= 100)
+    {
+      _escape = true;
+      _last = now;
+      continue;
+    }
+    _vr.sendRaw(rx);
+    _escape = false;
+    _replied = false;
+    _forwarded = true;
+    _last = _idle = now;
+  }
+  while (_vr.available())
+  {
+    _port.write(_vr.read());
+    _replied = true; // a status or an argument ends each exchange
+    _idle = now;
+  }
+  return true;
+}
+
+bool EasyVRBridge::acquire()
+{
+  if (!_mux)
+    return true; // not bridging, the link is always free
+  if (_held)
+    return true;
+  if (!_replied || _escape || millis() - _idle < _gap || _port.available() > 0)
+    return false;
+  if (_forwarded)
+  {
+    // the Commander may have selected another group or left a recognition
+    _vr._group = -1;
+    _vr._recog = EasyVR::RECOG_NONE;
+    _vr._recognizing = false;
+    _forwarded = false;
+  }
+  _held = true;
+  return true;
+}
+
+void EasyVRBridge::release()
+{
+  if (!_held)
+    return;
+  _held = false;
+  _replied = true;
+  _idle = millis();
+}
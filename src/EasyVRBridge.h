@@ -0,0 +1,135 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "EasyVR.h"
+
+/*****************************************************************************/
+
+/**
+  Detects a bridge mode request from the %EasyVR Commander in the background.
+
+  It is a non-blocking version of #EasyVR::bridgeRequested(): the handshake
+  is started with #begin() and followed by #poll() while the application
+  starts up normally, for a configurable time window. When the handshake
+  completes, #poll() returns the requested mode and the application can
+  set up the serial ports and enter bridge mode with #loop().
+
+  Bridge mode can also be multiplexed with the application: after
+  #beginMux(), #pollMux() forwards the traffic between the %EasyVR Commander
+  and the module without blocking, and the application can run its own
+  commands between Commander transactions, within #acquire() and #release().
+  The link is considered free when the module has replied to the last byte
+  sent by the Commander and no byte has been exchanged for a short time
+  (see #setIdleGap()). Meanwhile, bytes from the Commander are held in the
+  receive buffer of the serial port, so local transactions must be short.
+*/
+class EasyVRBridge
+{
+public:
+  enum
+  {
+    DEF_WINDOW = 1500,  /**< Default handshake window in milliseconds */
+    DEF_IDLE_GAP = 50,  /**< Default idle time before local commands in milliseconds */
+  };
+
+protected:
+  EasyVR& _vr;
+  Stream& _port;
+  unsigned long _start;   // time of handshake start
+  uint16_t _window;       // handshake window (0 = not listening)
+  bool _request;          // request header received
+  int8_t _mode;           // requested bridge mode
+  bool _mux;              // multiplexed bridge running
+  bool _held;             // link acquired by the application
+  bool _replied;          // last byte came from the module
+  bool _escape;           // escape character received
+  bool _forwarded;        // Commander traffic since the last local commands
+  uint16_t _gap;          // idle time before the link is free (in ms)
+  unsigned long _last;    // time of last byte from the Commander
+  unsigned long _idle;    // time of last byte in any direction
+
+  void reply(uint8_t c);
+
+public:
+  /**
+    Creates a bridge mode detector.
+    @param vr is the %EasyVR object to use in bridge mode
+    @param port is the target serial port (usually the PC serial port)
+  */
+  EasyVRBridge(EasyVR& vr, Stream& port);
+  /**
+    Starts listening for a bridge mode request.
+    @param window is the time in milliseconds to wait for the handshake
+  */
+  void begin(uint16_t window = DEF_WINDOW);
+  /**
+    Processes the handshake bytes received so far, without waiting. It must
+    be called often while listening (at least every few milliseconds).
+    @retval integer is #EasyVR::BRIDGE_NORMAL or #EasyVR::BRIDGE_BOOT when
+    bridge mode has been requested, otherwise #EasyVR::BRIDGE_NONE
+  */
+  int8_t poll();
+  /**
+    Tells if the handshake window is still open.
+    @retval true if a request can still be received
+  */
+  bool isListening() const { return _window != 0; }
+  /**
+    Gets the bridge mode requested during the last handshake window.
+    @retval integer is one of the values in #EasyVR::BridgeMode
+  */
+  int8_t getMode() const { return _mode; }
+  /**
+    Performs bridge mode until aborted, as #EasyVR::bridgeLoop(). The serial
+    ports must be set up for the requested mode before calling it.
+  */
+  void loop() { _vr.bridgeLoop(_port); }
+  /**
+    Starts multiplexed bridge mode. The serial ports must be set up for
+    #EasyVR::BRIDGE_NORMAL mode.
+  */
+  void beginMux();
+  /**
+    Forwards the bytes exchanged by the %EasyVR Commander and the module,
+    without waiting. It must be called often, ideally from the main loop.
+    @retval true if multiplexed bridge mode is still running, false if it has
+    been aborted with the escape character (see #EasyVR::BRIDGE_ESCAPE_CHAR)
+  */
+  bool pollMux();
+  /**
+    Tells if multiplexed bridge mode is running.
+    @retval true if running
+  */
+  bool isMuxActive() const { return _mux; }
+  /**
+    Sets the idle time required between Commander transactions and local
+    commands.
+    @param ms is the time in milliseconds with no bytes exchanged
+  */
+  void setIdleGap(uint16_t ms) { _gap = ms; }
+  /**
+    Tries to reserve the link to the module for local commands. If it
+    succeeds, traffic from the %EasyVR Commander is held until #release().
+    Since the Commander may have changed the state of the module, the
+    state cached by the %EasyVR object (such as the last used group) is
+    discarded.
+    @retval true if local commands can be sent now
+  */
+  bool acquire();
+  /**
+    Returns the link to the %EasyVR Commander, after local commands have
+    completed.
+  */
+  void release();
+};
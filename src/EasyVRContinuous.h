@@ -0,0 +1,172 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "Arduino.h"
+#include "EasyVRDispatcher.h"
+#include "internal/gaptimer.h"
+
+/*****************************************************************************/
+
+/**
+  Continuous recognition of custom commands or words.
+
+  The same group or word set is recognized again as soon as the previous
+  recognition completes (with a result, a timeout or a recognition error),
+  before the result is even stored, so that the module stops listening as
+  briefly as possible. Recognized commands and words are queued and can be
+  read later with #read(), or passed to #EasyVRDispatcher::dispatch().
+  @tparam N is the capacity of the result queue (a power of two up to 128)
+*/
+template <uint8_t N = 4>
+class EasyVRContinuous
+{
+  EasyVR& _vr;
+  EasyVRRing<EasyVRResult, N> _queue;
+  int8_t _target;         // group, or wordset + WORD_TARGET for words (-1 = stopped)
+  uint8_t _dropped;       // results lost because the queue was full
+  uint16_t _timeouts;     // recognitions ended without a result
+  uint16_t _errors;       // recognitions ended with an error
+  EasyVRGapTimer _timer;  // re-arm and poll timing
+
+  void arm()
+  {
+    if (_target >= EasyVR::WORD_TARGET)
+      _vr.recognizeWord(_target - EasyVR::WORD_TARGET);
+    else
+      _vr.recognizeCommand(_target);
+  }
+
+  void start(int8_t target)
+  {
+    _target = target;
+    _dropped = 0;
+    _timeouts = 0;
+    _errors = 0;
+    _queue.clear();
+    arm();
+    _timer.reset();
+  }
+
+public:
+  /**
+    Creates a continuous recognizer.
+    @param vr is the %EasyVR object to use
+  */
+  EasyVRContinuous(EasyVR& vr) : _vr(vr), _target(-1) {}
+  /**
+    Starts continuous recognition of custom commands.
+    @param group (0-16) is the target group, or one of the values in #EasyVR::Group
+  */
+  void recognizeCommand(int8_t group) { start(group); }
+  /**
+    Starts continuous recognition of built-in words or custom grammars.
+    @param wordset (0-31) is the target word set, or one of the values in #EasyVR::Wordset
+  */
+  void recognizeWord(int8_t wordset) { start(wordset + EasyVR::WORD_TARGET); }
+  /**
+    Stops continuous recognition.
+    @retval true if the module is back to ready
+  */
+  bool stop()
+  {
+    _target = -1;
+    return _vr.stop();
+  }
+  /**
+    Tells if continuous recognition is running.
+    @retval true if not stopped
+  */
+  bool isActive() const { return _target >= 0; }
+  /**
+    Checks for completion of the current recognition, re-arms it and queues
+    the result. It must be called often, ideally from the main loop.
+    @retval true if a recognition has completed
+  */
+  bool poll()
+  {
+    _timer.poll();
+    if (_target < 0 || !_vr.hasFinished())
+      return false;
+
+    EasyVRResult r;
+    EasyVRDispatcher::decode(_vr, r);
+    if (r.event == EasyVRDispatcher::ON_INVALID)
+    {
+      _target = -1;
+      return true;
+    }
+    arm();
+    _timer.rearmed();
+
+    if (r.event == EasyVRDispatcher::ON_COMMAND || r.event == EasyVRDispatcher::ON_WORD)
+    {
+      if (!_queue.push(r) && _dropped < 255)
+        ++_dropped;
+    }
+    else if (r.event == EasyVRDispatcher::ON_TIMEOUT)
+      ++_timeouts;
+    else
+      ++_errors;
+    return true;
+  }
+  /**
+    Gets the number of queued results.
+    @retval integer is the count of results that can be read
+  */
+  uint8_t available() const { return _queue.count(); }
+  /**
+    Removes the oldest result from the queue.
+    @param r is a variable that holds the result when the function returns
+    @retval true if a result was available
+  */
+  bool read(EasyVRResult& r) { return _queue.pop(r); }
+  /**
+    Gets the time taken by the last call to #poll() that detected the end of
+    a recognition to start the next one. The module may have been not
+    listening for up to this time plus the poll interval.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getLastGap() const { return _timer.gap(); }
+  /**
+    Gets the maximum of #getLastGap() since continuous recognition started.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getMaxGap() const { return _timer.maxGap(); }
+  /**
+    Gets the time between the last two calls to #poll(), that bounds how
+    late the end of a recognition may be detected.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getPollInterval() const { return _timer.interval(); }
+  /**
+    Gets the maximum of #getPollInterval() since continuous recognition started.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getMaxPollInterval() const { return _timer.maxInterval(); }
+  /**
+    Gets the number of results that did not fit in the queue.
+    @retval integer is the count of lost results
+  */
+  uint8_t getDropped() const { return _dropped; }
+  /**
+    Gets the number of recognitions that timed out.
+    @retval integer is the count of timeouts
+  */
+  uint16_t getTimeouts() const { return _timeouts; }
+  /**
+    Gets the number of recognitions that ended with an error.
+    @retval integer is the count of errors
+  */
+  uint16_t getErrors() const { return _errors; }
+};
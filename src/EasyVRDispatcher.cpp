@@ -0,0 +1,131 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#include "Arduino.h"
+#include "EasyVRDispatcher.h"
+
+/*****************************************************************************/
+
+enum // kinds of table keys
+{
+  KEY_COMMAND = 1, KEY_WORD = 2,
+};
+
+#define SLOT(k)   (((k) ^ ((k) >> 5) ^ ((k) >> 10)) & _mask)
+
+EasyVRDispatcher::EasyVRDispatcher(Entry* table, uint8_t size)
+  : _table(table), _mask(size - 1)
+{
+  memset(_table, 0, size * sizeof(Entry));
+  memset(_event, 0, sizeof(_event));
+}
+
+bool EasyVRDispatcher::add(uint16_t k, EasyVRHandler fn)
+{
+  uint8_t i = SLOT(k);
+  for (uint8_t n = 0; n <= _mask; ++n, i = (i + 1) & _mask)
+  {
+    if (_table[i].key == k || _table[i].key == 0)
+    {
+      // removed entries keep their key, so that probing is not broken
+      _table[i].key = k;
+      _table[i].fn = fn;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool EasyVRDispatcher::call(uint16_t k, int8_t set, int8_t index)
+{
+  uint8_t i = SLOT(k);
+  for (uint8_t n = 0; n <= _mask; ++n, i = (i + 1) & _mask)
+  {
+    if (_table[i].key == 0)
+      break;
+    if (_table[i].key == k)
+    {
+      if (_table[i].fn == NULL)
+        break;
+      _table[i].fn(set, index);
+      return true;
+    }
+  }
+  return false;
+}
+
+void EasyVRDispatcher::fire(int8_t event, int8_t set, int16_t value)
+{
+  if (_event[event] != NULL)
+    _event[event](set, value);
+}
+
+bool EasyVRDispatcher::onCommand(int8_t group, int8_t index, EasyVRHandler fn)
+{
+  return add(key(KEY_COMMAND, group, index), fn);
+}
+
+bool EasyVRDispatcher::onWord(int8_t wordset, int8_t index, EasyVRHandler fn)
+{
+  return add(key(KEY_WORD, wordset, index), fn);
+}
+
+void EasyVRDispatcher::onEvent(int8_t event, EasyVRHandler fn)
+{
+  if (event >= 0 && event < EVENT_COUNT)
+    _event[event] = fn;
+}
+
+void EasyVRDispatcher::decode(EasyVR& vr, EasyVRResult& r)
+{
+  r.time = millis();
+  r.set = -1;
+
+  if ((r.value = vr.getCommand()) >= 0)
+  {
+    r.event = ON_COMMAND;
+    r.set = vr.getRecognitionGroup();
+  }
+  else if ((r.value = vr.getWord()) >= 0)
+  {
+    r.event = ON_WORD;
+    r.set = vr.getRecognitionWordset();
+  }
+  else if ((r.value = vr.getToken()) >= 0)
+    r.event = ON_TOKEN;
+  else if ((r.value = vr.getError()) >= 0)
+    r.event = ON_ERROR;
+  else
+  {
+    r.value = 0;
+    if (vr.isTimeout())
+      r.event = ON_TIMEOUT;
+    else if (vr.isInvalid())
+      r.event = ON_INVALID;
+    else if (vr.isAwakened())
+      r.event = ON_AWAKEN;
+    else
+      r.event = ON_SUCCESS;
+  }
+}
+
+void EasyVRDispatcher::dispatch(const EasyVRResult& r)
+{
+  if (r.set >= 0)
+  {
+    if (r.event == ON_COMMAND && call(key(KEY_COMMAND, r.set, r.value), r.set, r.value))
+      return;
+    if (r.event == ON_WORD && call(key(KEY_WORD, r.set, r.value), r.set, r.value))
+      return;
+  }
+  fire(r.event, r.set, r.value);
+}
@@ -0,0 +1,160 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "EasyVR.h"
+
+/*****************************************************************************/
+
+/**
+  Type of the functions called by #EasyVRDispatcher.
+  @param set is the group or word set of the result, (-1) if not applicable
+  @param value is the command or word index, the token or the error code,
+  depending on the event
+*/
+typedef void (*EasyVRHandler)(int8_t set, int16_t value);
+
+/**
+  A decoded result of recognition or other asynchronous tasks.
+*/
+struct EasyVRResult
+{
+  uint8_t event;        /**< Type of result, one of the values in #EasyVRDispatcher::Event */
+  int8_t set;           /**< Group or word set of the result, (-1) if not applicable */
+  int16_t value;        /**< Command or word index, token or error code */
+  unsigned long time;   /**< Time of decoding, as returned by millis() */
+};
+
+/**
+  Routes the results of recognition and other asynchronous tasks to
+  handler functions.
+
+  Handlers can be registered for a specific command of a group, for a
+  specific word of a word set (or custom grammar) and for each type of
+  result. Each result is decoded once and looked up in a small hash table,
+  so the time from completion to the call of the handler does not depend
+  on the number of registered handlers. Storage is provided by the
+  #EasyVRDispatchTable template.
+*/
+class EasyVRDispatcher
+{
+public:
+  /** Types of results, used with #onEvent() */
+  enum Event
+  {
+    ON_COMMAND,   /**< A custom command without a specific handler has been recognized */
+    ON_WORD,      /**< A built-in word or grammar word without a specific handler has been recognized */
+    ON_TOKEN,     /**< A SonicNet token has been received */
+    ON_ERROR,     /**< An error occurred (the value is the error code) */
+    ON_TIMEOUT,   /**< The operation timed out */
+    ON_INVALID,   /**< The module reported an invalid command */
+    ON_AWAKEN,    /**< The module has been awakened from sleep mode */
+    ON_SUCCESS,   /**< The operation completed without a result (i.e. playback) */
+    EVENT_COUNT
+  };
+
+protected:
+  struct Entry
+  {
+    uint16_t key; // 0 = empty
+    EasyVRHandler fn;
+  };
+
+  Entry* _table;
+  uint8_t _mask; // table size - 1
+  EasyVRHandler _event[EVENT_COUNT];
+
+  EasyVRDispatcher(Entry* table, uint8_t size);
+
+  static uint16_t key(uint8_t kind, int8_t set, int8_t index)
+  {
+    return (kind << 10) | ((set & 0x1F) << 5) | (index & 0x1F);
+  }
+  bool add(uint16_t k, EasyVRHandler fn);
+  bool call(uint16_t k, int8_t set, int8_t index);
+  void fire(int8_t event, int8_t set, int16_t value);
+
+public:
+  /**
+    Registers a handler for a custom command.
+    @param group (0-16) is the group of the command, or one of the values in #EasyVR::Group
+    @param index (0-31) is the index of the command within the group
+    @param fn is the function to call (NULL to remove a previous handler)
+    @retval true if the operation is successful, false if the table is full
+  */
+  bool onCommand(int8_t group, int8_t index, EasyVRHandler fn);
+  /**
+    Registers a handler for a built-in word or a custom grammar word.
+    @param wordset (0-31) is the word set or grammar, or one of the values in #EasyVR::Wordset
+    @param index (0-31) is the index of the word within the word set
+    @param fn is the function to call (NULL to remove a previous handler)
+    @retval true if the operation is successful, false if the table is full
+  */
+  bool onWord(int8_t wordset, int8_t index, EasyVRHandler fn);
+  /**
+    Registers a handler for a type of result.
+    @param event is one of the values in #Event
+    @param fn is the function to call (NULL to remove a previous handler)
+  */
+  void onEvent(int8_t event, EasyVRHandler fn);
+  /**
+    Decodes the last result of the specified %EasyVR object.
+    @param vr is the %EasyVR object, after #EasyVR::hasFinished() returned true
+    @param r is a variable that holds the decoded result when the function returns
+  */
+  static void decode(EasyVR& vr, EasyVRResult& r);
+  /**
+    Calls the handler for a decoded result.
+    @param r is the result, as filled in by #decode()
+  */
+  void dispatch(const EasyVRResult& r);
+  /**
+    Calls the handler for the last result of the specified %EasyVR object.
+    @param vr is the %EasyVR object, after #EasyVR::hasFinished() returned true
+  */
+  void dispatch(EasyVR& vr)
+  {
+    EasyVRResult r;
+    decode(vr, r);
+    dispatch(r);
+  }
+  /**
+    Checks for completion of the pending task and dispatches its result.
+    @param vr is the %EasyVR object to poll
+    @retval true if a result has been dispatched
+  */
+  bool poll(EasyVR& vr)
+  {
+    if (!vr.hasFinished())
+      return false;
+    dispatch(vr);
+    return true;
+  }
+};
+
+/**
+  Storage for the command and word handlers.
+  @tparam N is the size of the handler table (a power of two up to 128),
+  it should be larger than the number of registered handlers
+*/
+template <uint8_t N>
+class EasyVRDispatchTable : public EasyVRDispatcher
+{
+  static_assert(N > 0 && N <= 128 && (N & (N - 1)) == 0,
+    "table size must be a power of two up to 128");
+
+  Entry _t[N];
+
+public:
+  EasyVRDispatchTable() : EasyVRDispatcher(_t, N) {}
+};
@@ -0,0 +1,125 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#include "Arduino.h"
+#include "EasyVRGrammars.h"
+
+/*****************************************************************************/
+
+EasyVRGrammars::EasyVRGrammars(char* pool, uint16_t poolSize, uint16_t* offset, uint16_t maxWords,
+  uint16_t* slot, uint16_t slots, uint16_t* first, uint8_t* flags, uint8_t maxGrammars)
+  : _pool(pool), _offset(offset), _slot(slot), _first(first), _flags(flags),
+  _poolSize(poolSize), _maxWords(maxWords), _slotMask(slots - 1), _maxGrammars(maxGrammars)
+{
+  clear();
+}
+
+uint16_t EasyVRGrammars::hash(int8_t grammar, const char* label)
+{
+  // FNV-1a (folded to 16 bits), case insensitive
+  uint32_t h = 2166136261UL ^ (uint8_t)grammar;
+  h *= 16777619UL;
+  for ( ; *label != 0; ++label)
+  {
+    h ^= (uint8_t)toupper(*label);
+    h *= 16777619UL;
+  }
+  return (uint16_t)(h ^ (h >> 16));
+}
+
+void EasyVRGrammars::clear()
+{
+  _count = 0;
+  _first[0] = 0;
+  memset(_slot, 0, (_slotMask + 1) * sizeof(uint16_t));
+}
+
+bool EasyVRGrammars::load(EasyVR& vr)
+{
+  clear();
+
+  int8_t n = vr.getGrammarsCount();
+  if (n < 0 || n > _maxGrammars)
+    return false;
+
+  uint16_t used = 0, w = 0;
+  for (int8_t g = 0; g < n; ++g)
+  {
+    uint8_t flags, count;
+    if (!vr.dumpGrammar(g, flags, count))
+      return false;
+    _flags[g] = flags;
+    for ( ; count > 0; --count, ++w)
+    {
+      if (w >= _maxWords || used >= _poolSize)
+        return false;
+      uint16_t room = _poolSize - used;
+      char* name = _pool + used;
+      if (!vr.getNextWordLabel(name, room > 255 ? 255 : room) || vr.isTruncated())
+        return false;
+      _offset[w] = used;
+      used += strlen(name) + 1;
+
+      uint16_t i = hash(g, name);
+      while (_slot[i & _slotMask] != 0)
+        ++i;
+      _slot[i & _slotMask] = w + 1;
+    }
+    _first[g + 1] = w;
+    _count = g + 1;
+  }
+  return true;
+}
+
+uint8_t EasyVRGrammars::wordCount(int8_t grammar) const
+{
+  if (grammar < 0 || grammar >= _count)
+    return 0;
+  return _first[grammar + 1] - _first[grammar];
+}
+
+uint8_t EasyVRGrammars::flags(int8_t grammar) const
+{
+  if (grammar < 0 || grammar >= _count)
+    return 0;
+  return _flags[grammar];
+}
+
+const char* EasyVRGrammars::label(int8_t grammar, int8_t word) const
+{
+  if (word < 0 || word >= wordCount(grammar))
+    return NULL;
+  return _pool + _offset[_first[grammar] + word];
+}
+
+uint16_t EasyVRGrammars::lookup(int8_t grammar, const char* label) const
+{
+  for (uint16_t i = hash(grammar, label); ; ++i)
+  {
+    uint16_t w = _slot[i & _slotMask];
+    if (w-- == 0)
+      return 0xFFFF;
+    if (w >= _first[grammar] && w < _first[grammar + 1]
+      && strcasecmp(_pool + _offset[w], label) == 0)
+      return w;
+  }
+}
+
+int8_t EasyVRGrammars::find(int8_t grammar, const char* label) const
+{
+  if (grammar < 0 || grammar >= _count)
+    return -1;
+  uint16_t w = lookup(grammar, label);
+  if (w == 0xFFFF)
+    return -1;
+  return w - _first[grammar];
+}
@@ -0,0 +1,118 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "EasyVR.h"
+
+/*****************************************************************************/
+
+/**
+  A local copy of all the word labels in the built-in word sets and custom
+  grammars of an %EasyVR module.
+
+  Labels are read once with #load() and stored one after the other in a
+  single string pool, so they can be retrieved by index or looked up by
+  name without querying the module again. Storage is provided by the
+  #EasyVRGrammarCache template.
+*/
+class EasyVRGrammars
+{
+protected:
+  char* _pool;          // label strings, zero terminated
+  uint16_t* _offset;    // pool offset of each word label
+  uint16_t* _slot;      // hash table of word numbers (+1, 0 = empty)
+  uint16_t* _first;     // first word number of each grammar (+1 sentinel)
+  uint8_t* _flags;      // flags of each grammar
+  uint16_t _poolSize;
+  uint16_t _maxWords;
+  uint16_t _slotMask;
+  uint8_t _maxGrammars;
+  int8_t _count;        // number of grammars loaded
+
+  EasyVRGrammars(char* pool, uint16_t poolSize, uint16_t* offset, uint16_t maxWords,
+    uint16_t* slot, uint16_t slots, uint16_t* first, uint8_t* flags, uint8_t maxGrammars);
+
+  static uint16_t hash(int8_t grammar, const char* label);
+  uint16_t lookup(int8_t grammar, const char* label) const;
+
+public:
+  /**
+    Reads all grammars and their word labels from the module.
+    @param vr is the %EasyVR object to query
+    @retval true if the operation is successful, false if communication
+    failed or some grammar did not fit in the available storage
+  */
+  bool load(EasyVR& vr);
+  /**
+    Discards all cached grammars.
+  */
+  void clear();
+  /**
+    Gets the number of cached grammars, including built-in word sets.
+    @retval integer is the count of grammars
+  */
+  int8_t count() const { return _count; }
+  /**
+    Gets the number of words in a grammar.
+    @param grammar (0-31) is the target grammar, or one of the values in #EasyVR::Wordset
+    @retval integer is the count of words (zero if grammar is not cached)
+  */
+  uint8_t wordCount(int8_t grammar) const;
+  /**
+    Gets the flags of a grammar.
+    @param grammar (0-31) is the target grammar, or one of the values in #EasyVR::Wordset
+    @retval integer is a combination of values in #EasyVR::GrammarFlag
+  */
+  uint8_t flags(int8_t grammar) const;
+  /**
+    Gets the label of a word.
+    @param grammar (0-31) is the target grammar, or one of the values in #EasyVR::Wordset
+    @param word (0-31) is the index of the word within the grammar, usually
+    returned by #EasyVR::getWord()
+    @retval string is the word label, NULL if not cached
+  */
+  const char* label(int8_t grammar, int8_t word) const;
+  /**
+    Looks up a word by label (not case sensitive).
+    @param grammar (0-31) is the target grammar, or one of the values in #EasyVR::Wordset
+    @param label is the word label to look for
+    @retval integer is the index of the word within the grammar, (-1) if not found
+  */
+  int8_t find(int8_t grammar, const char* label) const;
+};
+
+/**
+  Storage for the cached grammars.
+  @tparam POOL is the total size of all labels (including terminators)
+  @tparam WORDS is the total number of words in all grammars
+  @tparam GRAMMARS is the maximum number of grammars
+*/
+template <uint16_t POOL, uint16_t WORDS, uint8_t GRAMMARS = 32>
+class EasyVRGrammarCache : public EasyVRGrammars
+{
+  // hash table size: power of two, at least twice the number of words
+  static constexpr uint16_t slots(uint16_t n, uint16_t s = 2)
+  {
+    return s >= 2 * n ? s : slots(n, s * 2);
+  }
+
+  char _p[POOL];
+  uint16_t _o[WORDS];
+  uint16_t _s[slots(WORDS)];
+  uint16_t _f[GRAMMARS + 1];
+  uint8_t _fl[GRAMMARS];
+
+public:
+  EasyVRGrammarCache() : EasyVRGrammars(_p, POOL, _o, WORDS,
+    _s, slots(WORDS), _f, _fl, GRAMMARS) {}
+};
@@ -0,0 +1,152 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "Arduino.h"
+#include "EasyVR.h"
+
+/*****************************************************************************/
+
+/**
+  A mouth position sample collected during real-time lip-sync.
+*/
+struct EasyVRMouthFrame
+{
+  int8_t position;      /**< Mouth opening position (0-31) */
+  unsigned long time;   /**< Time of reception, as returned by millis() */
+};
+
+/**
+  Background reader of real-time lip-sync output.
+
+  After #start(), each call to #poll() keeps the request/reply exchange
+  with the module going, one request per lip-sync period, and stores the
+  mouth positions with their timestamps in a ring buffer. Animation code
+  can then consume the frames at its own pace with #read().
+  @tparam N is the capacity of the frame buffer (a power of two up to 128)
+*/
+template <uint8_t N = 8>
+class EasyVRLipsync
+{
+  EasyVR& _vr;
+  EasyVRRing<EasyVRMouthFrame, N> _frames;
+  bool _active;           // lip-sync running
+  bool _pending;          // request sent, waiting for reply
+  uint8_t _interval;      // minimum time between requests (in ms)
+  uint8_t _dropped;       // frames lost because the buffer was full
+  unsigned long _sent;    // time of last request (in ms)
+
+public:
+  enum
+  {
+    PERIOD = 25,  /**< Default time between requests (lip-sync refreshes every 27ms) */
+  };
+
+  /**
+    Creates a lip-sync reader.
+    @param vr is the %EasyVR object to use
+  */
+  EasyVRLipsync(EasyVR& vr) : _vr(vr), _active(false), _pending(false),
+    _interval(PERIOD), _dropped(0), _sent(0) {}
+  /**
+    Sets the minimum time between two requests to the module.
+    @param ms is the interval in milliseconds, see #PERIOD
+  */
+  void setInterval(uint8_t ms) { _interval = ms; }
+  /**
+    Starts real-time lip-sync and the background exchange.
+    @param threshold (0-1023) is a measure of the strength of the input signal
+    below which the mouth is considered to be closed (see #EasyVR::LipsyncThreshold)
+    @param timeout (0-255) is the maximum duration of lip-sync in seconds,
+    0 means infinite
+    @retval true if the operation is successfully started
+  */
+  bool start(int16_t threshold, uint8_t timeout)
+  {
+    _frames.clear();
+    _dropped = 0;
+    _pending = false;
+    _active = _vr.realtimeLipsync(threshold, timeout);
+    _sent = millis();
+    return _active;
+  }
+  /**
+    Stops real-time lip-sync.
+    @retval true if the module is back to ready
+  */
+  bool stop()
+  {
+    _active = false;
+    _pending = false;
+    return _vr.stop();
+  }
+  /**
+    Tells if lip-sync is still running. When it ends by itself, the reason
+    is available from #EasyVR::isTimeout() or #EasyVR::getError().
+    @retval true if lip-sync is running
+  */
+  bool isActive() const { return _active; }
+  /**
+    Keeps the exchange with the module going. It must be called often,
+    ideally from the main loop, and it never waits.
+    @retval true if a new frame has been stored
+  */
+  bool poll()
+  {
+    if (!_active)
+      return false;
+    unsigned long now = millis();
+    if (!_pending)
+    {
+      if (now - _sent < _interval)
+        return false;
+      _vr.requestMouthPosition();
+      _sent = now;
+      _pending = true;
+      return false;
+    }
+    int8_t pos;
+    if (!_vr.hasMouthPosition(pos))
+    {
+      if (now - _sent > _vr.getReplyTimeout(EasyVR::TIMEOUT_DEFAULT))
+        stop(); // no reply, communication lost
+      return false;
+    }
+    _pending = false;
+    if (pos < 0)
+    {
+      _active = false; // finished
+      return false;
+    }
+    EasyVRMouthFrame f = { pos, now };
+    if (!_frames.push(f) && _dropped < 255)
+      ++_dropped;
+    return true;
+  }
+  /**
+    Gets the number of buffered frames.
+    @retval integer is the count of frames that can be read
+  */
+  uint8_t available() const { return _frames.count(); }
+  /**
+    Removes the oldest frame from the buffer.
+    @param f is a variable that holds the frame when the function returns
+    @retval true if a frame was available
+  */
+  bool read(EasyVRMouthFrame& f) { return _frames.pop(f); }
+  /**
+    Gets the number of frames that did not fit in the buffer.
+    @retval integer is the count of lost frames
+  */
+  uint8_t getDropped() const { return _dropped; }
+};
@@ -0,0 +1,143 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#include "Arduino.h"
+#include "EasyVRMessages.h"
+
+/*****************************************************************************/
+
+EasyVRMessages::EasyVRMessages(EasyVR& vr) : _vr(vr), _capacity(0), _pending(-1)
+{
+  memset(_slot, 0, sizeof(_slot));
+}
+
+bool EasyVRMessages::refresh(int8_t index)
+{
+  int8_t type;
+  int32_t length;
+  if (_vr.dumpMessage(index, type, length))
+  {
+    set(index, type, length);
+    return true;
+  }
+  // only a STS_ERROR reply carries an error code (communication errors
+  // have no code), otherwise the slot may not even have been read
+  int16_t err = _vr.getError();
+  if (err <= 0)
+    return false; // communication error, keep old information
+  set(index, err == EasyVR::ERR_RP_NO_MSG ? (int8_t)EasyVR::MSG_EMPTY : (int8_t)MSG_BAD, 0);
+  return true;
+}
+
+bool EasyVRMessages::scan()
+{
+  for (int8_t i = 0; i < SLOTS; ++i)
+  {
+    if (!refresh(i))
+      return false;
+  }
+  return true;
+}
+
+int8_t EasyVRMessages::allocate() const
+{
+  for (int8_t i = 0; i < SLOTS; ++i)
+  {
+    if (_slot[i] == 0 && i != _pending)
+      return i;
+  }
+  return -1;
+}
+
+uint8_t EasyVRMessages::getUsedSlots() const
+{
+  uint8_t n = 0;
+  for (int8_t i = 0; i < SLOTS; ++i)
+  {
+    if (_slot[i] != 0)
+      ++n;
+  }
+  return n;
+}
+
+uint32_t EasyVRMessages::getUsedBytes() const
+{
+  uint32_t n = 0;
+  for (int8_t i = 0; i < SLOTS; ++i)
+    n += getLength(i);
+  return n;
+}
+
+uint32_t EasyVRMessages::getFreeBytes() const
+{
+  uint32_t used = getUsedBytes();
+  return _capacity > used ? _capacity - used : 0;
+}
+
+int8_t EasyVRMessages::recordAsync(int8_t bits, int8_t timeout)
+{
+  int8_t index = allocate();
+  if (index < 0)
+    return -1;
+  _pending = index;
+  _vr.recordMessageAsync(index, bits, timeout);
+  return index;
+}
+
+void EasyVRMessages::eraseAsync(int8_t index)
+{
+  _pending = index;
+  _vr.eraseMessageAsync(index);
+}
+
+bool EasyVRMessages::poll()
+{
+  if (!_vr.hasFinished())
+    return false;
+  if (_pending >= 0)
+  {
+    if (_vr.getError() < 0 && getType(_pending) != EasyVR::MSG_EMPTY)
+      set(_pending, EasyVR::MSG_EMPTY, 0); // successful erase
+    else
+      refresh(_pending); // recording, or failed erase
+    _pending = -1;
+  }
+  return true;
+}
+
+bool EasyVRMessages::stop()
+{
+  bool ok = _vr.stop();
+  if (_pending >= 0)
+  {
+    refresh(_pending);
+    _pending = -1;
+  }
+  return ok;
+}
+
+bool EasyVRMessages::reset()
+{
+  _pending = -1;
+  if (!_vr.resetMessages())
+    return false;
+  memset(_slot, 0, sizeof(_slot));
+  return true;
+}
+
+bool EasyVRMessages::fix()
+{
+  _pending = -1;
+  if (!_vr.fixMessages())
+    return false;
+  return scan();
+}
@@ -0,0 +1,138 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "EasyVR.h"
+
+/*****************************************************************************/
+
+/**
+  Keeps track of the recorded message slots of an %EasyVR module.
+
+  All slots are read once with #scan(), then the map is kept up to date by
+  the functions of this class that record, erase, reset or fix messages,
+  so that free slots and used storage are known without querying the module.
+  While a recording or an erase is in progress, completion must be checked
+  with #poll() instead of #EasyVR::hasFinished().
+*/
+class EasyVRMessages
+{
+public:
+  enum
+  {
+    SLOTS = 32,     /**< Number of message slots */
+    MSG_BAD = -1,   /**< Type of a slot with errors (see #EasyVR::fixMessages()) */
+  };
+
+protected:
+  EasyVR& _vr;
+  uint32_t _slot[SLOTS];  // type in high byte, length in lower bytes
+  uint32_t _capacity;     // total storage size (0 = unknown)
+  int8_t _pending;        // slot being recorded or erased (-1 = none)
+
+  bool refresh(int8_t index);
+  void set(int8_t index, int8_t type, int32_t length)
+  {
+    _slot[index] = ((uint32_t)(uint8_t)type << 24) | (length & 0xFFFFFFUL);
+  }
+
+public:
+  /**
+    Creates a message manager (all slots are considered empty until #scan()).
+    @param vr is the %EasyVR object to use
+  */
+  EasyVRMessages(EasyVR& vr);
+  /**
+    Reads the type and length of all message slots.
+    @retval true if the operation is successful
+  */
+  bool scan();
+  /**
+    Sets the total size of the message storage, used by #getFreeBytes().
+    @param bytes is the storage size in bytes
+  */
+  void setCapacity(uint32_t bytes) { _capacity = bytes; }
+  /**
+    Gets the type of a message.
+    @param index (0-31) is the index of the message slot
+    @retval integer is one of the values in #EasyVR::MessageType, or #MSG_BAD
+  */
+  int8_t getType(int8_t index) const { return (int8_t)(_slot[index] >> 24); }
+  /**
+    Gets the length of a message.
+    @param index (0-31) is the index of the message slot
+    @retval integer is the message length in bytes
+  */
+  int32_t getLength(int8_t index) const { return _slot[index] & 0xFFFFFFUL; }
+  /**
+    Finds an empty message slot.
+    @retval (0-31) is the index of the first empty slot, (-1) if all slots are used
+  */
+  int8_t allocate() const;
+  /**
+    Gets the number of slots that contain a message (including bad ones).
+    @retval integer is the count of used slots
+  */
+  uint8_t getUsedSlots() const;
+  /**
+    Gets the number of empty slots.
+    @retval integer is the count of free slots
+  */
+  uint8_t getFreeSlots() const { return SLOTS - getUsedSlots(); }
+  /**
+    Gets the total length of recorded messages.
+    @retval integer is the used storage in bytes
+  */
+  uint32_t getUsedBytes() const;
+  /**
+    Gets the free storage, if the capacity has been set with #setCapacity().
+    @retval integer is the free storage in bytes (0 if capacity is unknown)
+  */
+  uint32_t getFreeBytes() const;
+  /**
+    Starts recording a message in the first empty slot. Check for completion
+    with #poll().
+    @param bits (8) specifies the audio format (see #EasyVR::MessageType)
+    @param timeout (0-31) is the maximum recording time (0=infinite)
+    @retval (0-31) is the index of the slot being recorded, (-1) if there
+    are no free slots
+  */
+  int8_t recordAsync(int8_t bits, int8_t timeout);
+  /**
+    Starts erasing a message. Check for completion with #poll().
+    @param index (0-31) is the index of the message slot
+  */
+  void eraseAsync(int8_t index);
+  /**
+    Checks for completion of a recording or erase operation and updates the
+    affected slot.
+    @retval true if the operation has completed
+  */
+  bool poll();
+  /**
+    Interrupts a recording (the partial message is kept) and updates the slot.
+    @retval true if the module is back to ready
+  */
+  bool stop();
+  /**
+    Erases all messages, see #EasyVR::resetMessages().
+    @retval true if the operation is successful
+  */
+  bool reset();
+  /**
+    Recovers from memory errors and reads all slots again,
+    see #EasyVR::fixMessages().
+    @retval true if the operation is successful
+  */
+  bool fix();
+};
@@ -0,0 +1,86 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#include "Arduino.h"
+#include "EasyVRMouthFilter.h"
+
+/*****************************************************************************/
+
+// lip-sync refresh period (in ms)
+static const uint8_t FRAME_TIME = 27;
+
+// one step of the envelope: moves by diff * coef / 256 (at least 1)
+static inline uint8_t approach(uint8_t diff, uint8_t coef)
+{
+  uint8_t d = ((uint16_t)diff * coef + 128) >> 8;
+  return d != 0 ? d : 1;
+}
+
+void EasyVRMouthFilter::reset()
+{
+  _env = 0;
+  _prev = 0;
+  _step = 0;
+  _time = millis();
+  _peak = _time;
+  _next = _time;
+}
+
+void EasyVRMouthFilter::push(const EasyVRMouthFrame& f)
+{
+  uint8_t x = (f.position & 0x1F) << 3; // 0-248
+
+  _prev = _env;
+  if (x > _env)
+  {
+    _env += approach(x - _env, _attack);
+    _peak = f.time;
+  }
+  else if (x < _env && f.time - _peak >= _hold)
+  {
+    _env -= approach(_env - x, _release);
+  }
+
+  unsigned long dt = f.time - _time;
+  if (dt > 2 * FRAME_TIME)
+    dt = FRAME_TIME; // after a pause, move over one period as usual
+  _step = dt != 0 ? 65535U / (uint16_t)dt : 65535U;
+  _time = f.time;
+}
+
+uint8_t EasyVRMouthFilter::value(unsigned long now) const
+{
+  // one frame behind: go from _prev to _env over the last frame period
+  unsigned long t = now - _time;
+  uint32_t frac = (uint32_t)(t & 0xFFFF) * _step; // 16.16, 0x10000 = 1
+  uint8_t v = _env;
+  if (t <= 0xFFFF && frac < 0x10000UL)
+  {
+    uint16_t f = frac >> 8;
+    if (_env > _prev)
+      v = _prev + (((uint16_t)(_env - _prev) * f) >> 8);
+    else
+      v = _prev - (((uint16_t)(_prev - _env) * f) >> 8);
+  }
+  return v + (v >> 5); // 0-248 to 0-255
+}
+
+bool EasyVRMouthFilter::poll(unsigned long now, uint8_t& v)
+{
+  if ((long)(now - _next) < 0)
+    return false;
+  _next += _interval;
+  if ((long)(now - _next) >= 0)
+    _next = now + _interval; // late, don't try to catch up
+  v = value(now);
+  return true;
+}
@@ -0,0 +1,102 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "EasyVRLipsync.h"
+
+/*****************************************************************************/
+
+/**
+  Smoothing and interpolation of lip-sync mouth positions.
+
+  Each input frame goes through an attack/release envelope (optionally
+  holding peaks for a while), then output values are linearly interpolated
+  between the last two envelope points, one frame behind, so that they can
+  be sampled at any rate (i.e. a servo refresh period). Only 8 and 16 bit
+  integer arithmetic is used on the input path, output sampling needs one
+  32 bit multiplication.
+
+  Output values are in the range 0-255 (like analogWrite()).
+*/
+class EasyVRMouthFilter
+{
+  uint8_t _attack;        // envelope coefficient when opening (1-255, 255 = fastest)
+  uint8_t _release;       // envelope coefficient when closing (1-255, 255 = fastest)
+  uint8_t _hold;          // peak hold time (in ms)
+  uint8_t _interval;      // output interval (in ms)
+  uint8_t _env;           // current envelope (position * 8)
+  uint8_t _prev;          // previous envelope (position * 8)
+  uint16_t _step;         // 65536 / time between last two frames
+  unsigned long _time;    // time of last frame
+  unsigned long _peak;    // time of last peak
+  unsigned long _next;    // time of next output sample
+
+public:
+  /**
+    Creates a filter.
+    @param attack (1-255) is the envelope coefficient when the mouth opens,
+    255 follows the input immediately, lower values are smoother
+    @param release (1-255) is the envelope coefficient when the mouth closes
+    @param hold (0-255) is the time in milliseconds the envelope is held at a
+    peak, before it can start closing
+  */
+  EasyVRMouthFilter(uint8_t attack = 192, uint8_t release = 96, uint8_t hold = 0)
+    : _attack(attack), _release(release), _hold(hold), _interval(20)
+  {
+    reset();
+  }
+  /**
+    Sets the envelope coefficient when the mouth opens.
+    @param attack (1-255) is the coefficient, 255 follows the input immediately
+  */
+  void setAttack(uint8_t attack) { _attack = attack; }
+  /**
+    Sets the envelope coefficient when the mouth closes.
+    @param release (1-255) is the coefficient, 255 follows the input immediately
+  */
+  void setRelease(uint8_t release) { _release = release; }
+  /**
+    Sets the peak hold time.
+    @param ms (0-255) is the time in milliseconds, 0 disables peak hold
+  */
+  void setHold(uint8_t ms) { _hold = ms; }
+  /**
+    Sets the output sampling interval, used by #poll().
+    @param ms (1-255) is the time between two output values in milliseconds
+  */
+  void setOutputInterval(uint8_t ms) { _interval = ms; }
+  /**
+    Brings the filter back to the closed mouth position.
+  */
+  void reset();
+  /**
+    Feeds a new mouth position.
+    @param f is a frame as returned by #EasyVRLipsync::read()
+  */
+  void push(const EasyVRMouthFrame& f);
+  /**
+    Gets the interpolated output at the specified time.
+    @param now is the current time, as returned by millis()
+    @retval (0-255) is the filtered mouth opening
+  */
+  uint8_t value(unsigned long now) const;
+  /**
+    Gets the interpolated output if a new sample is due, according to the
+    output interval.
+    @param now is the current time, as returned by millis()
+    @param v is a variable that holds the filtered mouth opening (0-255)
+    when the function returns true
+    @retval true if a new output value is available
+  */
+  bool poll(unsigned long now, uint8_t& v);
+};
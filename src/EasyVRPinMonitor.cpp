@@ -0,0 +1,62 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#include "Arduino.h"
+#include "EasyVRPinMonitor.h"
+
+/*****************************************************************************/
+
+EasyVRPinMonitor::EasyVRPinMonitor(EasyVR& vr) : _vr(vr), _handler(NULL), _pins(0),
+  _config(EasyVR::INPUT_STRONG), _interval(DEF_INTERVAL), _levels(-1), _last(0),
+  _cost(0), _maxCost(0), _reads(0), _changes(0), _errors(0)
+{
+}
+
+void EasyVRPinMonitor::begin(uint8_t pins, int8_t config, uint16_t interval)
+{
+  _pins = pins;
+  _config = config;
+  _interval = interval;
+  _levels = -1;
+  _last = millis() - interval; // read at first poll
+}
+
+bool EasyVRPinMonitor::poll()
+{
+  if (_pins == 0)
+    return false;
+  unsigned long now = millis();
+  if (now - _last < _interval)
+    return false;
+  _last = now;
+
+  unsigned long start = micros();
+  int8_t levels = _vr.getPinInputs(_pins, _config);
+  _cost = micros() - start;
+  if (_cost > _maxCost)
+    _maxCost = _cost;
+  ++_reads;
+
+  if (levels < 0)
+  {
+    ++_errors;
+    return false;
+  }
+  int8_t prev = _levels;
+  _levels = levels;
+  if (prev < 0 || prev == levels)
+    return false;
+  ++_changes;
+  if (_handler != NULL)
+    _handler(levels, levels ^ prev);
+  return true;
+}
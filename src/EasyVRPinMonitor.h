@@ -0,0 +1,122 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "EasyVR.h"
+
+/*****************************************************************************/
+
+/**
+  Type of the function called when monitored pins change state.
+  @param levels is a bit mask of the logical values of the pins (bit 0 for
+  #EasyVR::IO1, bit 1 for #EasyVR::IO2 and so on)
+  @param changed is a bit mask of the pins that have changed
+*/
+typedef void (*EasyVRPinHandler)(uint8_t levels, uint8_t changed);
+
+/**
+  Watches a set of input pins of an %EasyVR module, for example to use them
+  as extra buttons.
+
+  The pins are read with #EasyVR::getPinInputs() at a fixed rate and the
+  handler is called only when their state changes. Each read takes one
+  command round trip per pin, so the time spent is measured and can be
+  checked with #getPollCost() to choose the rate. Reading the pins
+  interrupts any recognition or playback in progress, so the monitor
+  should be polled only while the module is otherwise idle.
+*/
+class EasyVRPinMonitor
+{
+public:
+  enum
+  {
+    DEF_INTERVAL = 50,  /**< Default time between reads (in ms) */
+  };
+
+protected:
+  EasyVR& _vr;
+  EasyVRPinHandler _handler;
+  uint8_t _pins;
+  int8_t _config;
+  uint16_t _interval;
+  int8_t _levels;           // last pin values (-1 = unknown)
+  unsigned long _last;      // time of last read (in ms)
+  unsigned long _cost;      // duration of last read (in us)
+  unsigned long _maxCost;
+  uint16_t _reads;
+  uint16_t _changes;
+  uint16_t _errors;
+
+public:
+  /**
+    Creates a pin monitor.
+    @param vr is the %EasyVR object to use
+  */
+  EasyVRPinMonitor(EasyVR& vr);
+  /**
+    Starts monitoring a set of pins.
+    @param pins is a bit mask of the pins to read (bit 0 for #EasyVR::IO1,
+    bit 1 for #EasyVR::IO2 and so on)
+    @param config (2-4) is one of the input values in #EasyVR::PinConfig
+    @param interval is the time between reads in milliseconds
+  */
+  void begin(uint8_t pins, int8_t config = EasyVR::INPUT_STRONG, uint16_t interval = DEF_INTERVAL);
+  /**
+    Sets the function to call when the monitored pins change.
+    @param handler is the function to call, or NULL to disable
+  */
+  void setHandler(EasyVRPinHandler handler) { _handler = handler; }
+  /**
+    Sets the time between reads.
+    @param interval is the time in milliseconds
+  */
+  void setInterval(uint16_t interval) { _interval = interval; }
+  /**
+    Reads the pins if the interval has elapsed and calls the handler if
+    they have changed. It must be called often, ideally from the main loop.
+    The first read only sets the initial state.
+    @retval true if the pins have changed
+  */
+  bool poll();
+  /**
+    Gets the last known values of the monitored pins.
+    @retval integer is a bit mask of the logical values of the pins, or
+    (-1) if not read yet
+  */
+  int8_t getLevels() const { return _levels; }
+  /**
+    Gets the time taken by the last read of the pins.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getPollCost() const { return _cost; }
+  /**
+    Gets the maximum of #getPollCost() since monitoring started.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getMaxPollCost() const { return _maxCost; }
+  /**
+    Gets the number of times the pins have been read.
+    @retval integer is the count of reads
+  */
+  uint16_t getReads() const { return _reads; }
+  /**
+    Gets the number of state changes reported.
+    @retval integer is the count of changes
+  */
+  uint16_t getChanges() const { return _changes; }
+  /**
+    Gets the number of failed reads.
+    @retval integer is the count of errors
+  */
+  uint16_t getErrors() const { return _errors; }
+};
@@ -0,0 +1,78 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#include "Arduino.h"
+#include "EasyVRPipeline.h"
+
+/*****************************************************************************/
+
+void EasyVRPipeline::enter(int8_t stage)
+{
+  if (stage < 0 || stage >= _count)
+  {
+    _stage = END;
+    return;
+  }
+  _stage = stage;
+  const EasyVRStage& s = _stages[stage];
+  if (s.timeout >= 0)
+    _vr.setTimeout(s.timeout);
+  if (s.group >= 0)
+    _vr.recognizeCommand(s.group);
+  else
+    _vr.recognizeWord(s.wordset);
+}
+
+int8_t EasyVRPipeline::next(const EasyVRStage& s, const EasyVRResult& r)
+{
+  switch (r.event)
+  {
+  case EasyVRDispatcher::ON_COMMAND:
+  case EasyVRDispatcher::ON_WORD:
+    if (s.branch != NULL && r.value < s.branches)
+      return s.branch[r.value];
+    return s.onResult;
+
+  case EasyVRDispatcher::ON_TIMEOUT:
+    return s.onTimeout;
+  }
+  return s.onError;
+}
+
+void EasyVRPipeline::start(int8_t stage)
+{
+  enter(stage);
+  _timer.reset();
+}
+
+bool EasyVRPipeline::stop()
+{
+  _stage = END;
+  return _vr.stop();
+}
+
+bool EasyVRPipeline::poll()
+{
+  _timer.poll();
+  if (_stage == END || !_vr.hasFinished())
+    return false;
+
+  EasyVRResult r;
+  EasyVRDispatcher::decode(_vr, r);
+  int8_t done = _stage;
+  enter(next(_stages[done], r));
+  _timer.rearmed();
+
+  if (_handler != NULL)
+    _handler(done, r);
+  return true;
+}
@@ -0,0 +1,129 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "EasyVRDispatcher.h"
+#include "internal/gaptimer.h"
+
+/*****************************************************************************/
+
+/**
+  A recognition stage of an #EasyVRPipeline.
+
+  Next stage numbers are indexes in the array of stages, or
+  #EasyVRPipeline::END to stop the pipeline.
+*/
+struct EasyVRStage
+{
+  int8_t group;         /**< Group of custom commands to recognize (0-16), or (-1) to recognize words */
+  int8_t wordset;       /**< Word set or custom grammar to recognize, when group is (-1) */
+  int8_t timeout;       /**< Recognition timeout in seconds to set when entering the stage, (-1) to keep the current one */
+  int8_t onResult;      /**< Next stage when a command or word is recognized */
+  int8_t onTimeout;     /**< Next stage when recognition times out */
+  int8_t onError;       /**< Next stage when recognition fails */
+  const int8_t* branch; /**< Next stage for each command or word index, overrides onResult (can be NULL) */
+  uint8_t branches;     /**< Number of entries in the branch array */
+};
+
+/**
+  Type of the functions called by #EasyVRPipeline when a stage completes.
+  @param stage is the index of the completed stage
+  @param r is the result of the stage
+*/
+typedef void (*EasyVRStageHandler)(int8_t stage, const EasyVRResult& r);
+
+/**
+  Runs a graph of recognition stages, such as a trigger word followed by a
+  group of commands chosen by the trigger, and then a password check.
+
+  When a stage completes, the recognition for the next stage is started
+  before anything else, including the call to the handler, so that the
+  module goes back to listening as soon as possible. Everything runs from
+  #poll() and nothing blocks while waiting for the user to speak.
+*/
+class EasyVRPipeline
+{
+public:
+  enum
+  {
+    END = -1,   /**< Next stage value that stops the pipeline */
+  };
+
+protected:
+  EasyVR& _vr;
+  const EasyVRStage* _stages;
+  EasyVRStageHandler _handler;
+  uint8_t _count;
+  int8_t _stage;          // current stage (END when stopped)
+  EasyVRGapTimer _timer;  // re-arm and poll timing
+
+  void enter(int8_t stage);
+  int8_t next(const EasyVRStage& s, const EasyVRResult& r);
+
+public:
+  /**
+    Creates a pipeline.
+    @param vr is the %EasyVR object to use
+    @param stages is the array of stages, it must stay valid while in use
+    @param count is the number of stages
+    @param handler is the function called when each stage completes (can be NULL)
+  */
+  EasyVRPipeline(EasyVR& vr, const EasyVRStage* stages, uint8_t count,
+    EasyVRStageHandler handler = NULL)
+    : _vr(vr), _stages(stages), _handler(handler), _count(count),
+    _stage(END) {}
+  /**
+    Starts the pipeline.
+    @param stage is the index of the first stage
+  */
+  void start(int8_t stage = 0);
+  /**
+    Stops the pipeline, interrupting the current recognition.
+    @retval true if the module is back to ready
+  */
+  bool stop();
+  /**
+    Gets the current stage.
+    @retval integer is the index of the stage being recognized, #END if stopped
+  */
+  int8_t getStage() const { return _stage; }
+  /**
+    Checks for completion of the current stage and moves to the next one.
+    It must be called often, ideally from the main loop.
+    @retval true if a stage has completed
+  */
+  bool poll();
+  /**
+    Gets the time taken by the last call to #poll() that detected the end of
+    a stage to start the next one. The module may have been not listening
+    for up to this time plus the poll interval.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getLastGap() const { return _timer.gap(); }
+  /**
+    Gets the maximum of #getLastGap() since the pipeline started.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getMaxGap() const { return _timer.maxGap(); }
+  /**
+    Gets the time between the last two calls to #poll(), that bounds how
+    late the end of a stage may be detected.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getPollInterval() const { return _timer.interval(); }
+  /**
+    Gets the maximum of #getPollInterval() since the pipeline started.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getMaxPollInterval() const { return _timer.maxInterval(); }
+};
@@ -0,0 +1,196 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "Arduino.h"
+#include "EasyVR.h"
+#include "internal/gaptimer.h"
+
+/*****************************************************************************/
+
+/**
+  An entry of an #EasyVRPlaylist.
+*/
+struct EasyVRPlayItem
+{
+  uint8_t type;   /**< One of the values in #EasyVRPlaylist::ItemType */
+  int16_t index;  /**< Sound index, message index or tone */
+  int8_t arg1;    /**< Sound volume, message speed or tone duration */
+  int8_t arg2;    /**< Message attenuation */
+};
+
+/**
+  Plays a sequence of sounds, recorded messages and phone tones.
+
+  Items are queued with #addSound(), #addMessage() and #addTone(), and each
+  one is started by #poll() as soon as the module reports completion of the
+  previous one, so that the application never waits for playback.
+  @tparam N is the capacity of the queue (a power of two up to 128)
+*/
+template <uint8_t N = 8>
+class EasyVRPlaylist
+{
+public:
+  /** Types of playlist items */
+  enum ItemType
+  {
+    ITEM_SOUND,     /**< A sound from the sound table */
+    ITEM_MESSAGE,   /**< A recorded message */
+    ITEM_TONE,      /**< A phone tone */
+  };
+
+private:
+  EasyVR& _vr;
+  EasyVRRing<EasyVRPlayItem, N> _queue;
+  bool _playing;          // an item has been started
+  uint16_t _errors;       // items that completed with an error
+  EasyVRGapTimer _timer;  // re-arm and poll timing
+
+  bool add(uint8_t type, int16_t index, int8_t arg1, int8_t arg2)
+  {
+    EasyVRPlayItem item = { type, index, arg1, arg2 };
+    return _queue.push(item);
+  }
+
+  bool next()
+  {
+    EasyVRPlayItem item;
+    if (!_queue.pop(item))
+      return false;
+    switch (item.type)
+    {
+    case ITEM_SOUND:
+      _vr.playSoundAsync(item.index, item.arg1);
+      break;
+    case ITEM_MESSAGE:
+      _vr.playMessageAsync(item.index, item.arg1, item.arg2);
+      break;
+    case ITEM_TONE:
+      _vr.playPhoneToneAsync(item.index, item.arg1);
+      break;
+    }
+    return true;
+  }
+
+public:
+  /**
+    Creates a playlist.
+    @param vr is the %EasyVR object to use
+  */
+  EasyVRPlaylist(EasyVR& vr) : _vr(vr), _playing(false), _errors(0) {}
+  /**
+    Queues a sound from the sound table.
+    @param index is the index of the target sound in the sound table
+    @param volume (0-31) may be one of the values in #EasyVR::SoundVolume
+    @retval true if the item has been queued, false if the queue is full
+  */
+  bool addSound(int16_t index, int8_t volume)
+  {
+    return add(ITEM_SOUND, index, volume, 0);
+  }
+  /**
+    Queues a recorded message.
+    @param index (0-31) is the index of the target message slot
+    @param speed (0-1) may be one of the values in #EasyVR::MessageSpeed
+    @param atten (0-3) may be one of the values in #EasyVR::MessageAttenuation
+    @retval true if the item has been queued, false if the queue is full
+  */
+  bool addMessage(int8_t index, int8_t speed, int8_t atten)
+  {
+    return add(ITEM_MESSAGE, index, speed, atten);
+  }
+  /**
+    Queues a phone tone.
+    @param tone is the index of the tone (see #EasyVR::playPhoneTone())
+    @param duration (1-32) is the tone duration in 40 milliseconds units, or
+    in seconds for the dial tone
+    @retval true if the item has been queued, false if the queue is full
+  */
+  bool addTone(int8_t tone, uint8_t duration)
+  {
+    return add(ITEM_TONE, tone, duration, 0);
+  }
+  /**
+    Starts the next item when the previous one has completed. It must be
+    called often, ideally from the main loop.
+    @retval true if a new item has been started
+  */
+  bool poll()
+  {
+    _timer.poll();
+    if (_playing)
+    {
+      if (!_vr.hasFinished())
+        return false;
+      if (_vr.getError() >= 0)
+        ++_errors;
+      _playing = next();
+      if (!_playing)
+        return false;
+      _timer.rearmed();
+      return true;
+    }
+    _playing = next();
+    return _playing;
+  }
+  /**
+    Interrupts playback and empties the queue.
+    @retval true if the module is back to ready
+  */
+  bool stop()
+  {
+    _queue.clear();
+    if (!_playing)
+      return true;
+    _playing = false;
+    return _vr.stop();
+  }
+  /**
+    Tells if an item is playing.
+    @retval true if the module is busy with playback
+  */
+  bool isPlaying() const { return _playing; }
+  /**
+    Gets the number of queued items, not yet started.
+    @retval integer is the count of items
+  */
+  uint8_t available() const { return _queue.count(); }
+  /**
+    Gets the time taken by the last call to #poll() that detected the end of
+    an item to start the next one. The silence between the two items may be
+    up to this time plus the poll interval.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getLastGap() const { return _timer.gap(); }
+  /**
+    Gets the maximum of #getLastGap() since the playlist was created.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getMaxGap() const { return _timer.maxGap(); }
+  /**
+    Gets the time between the last two calls to #poll(), that bounds how
+    late the end of an item may be detected.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getPollInterval() const { return _timer.interval(); }
+  /**
+    Gets the maximum of #getPollInterval() since the playlist was created.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getMaxPollInterval() const { return _timer.maxInterval(); }
+  /**
+    Gets the number of items that completed with an error.
+    @retval integer is the count of errors
+  */
+  uint16_t getErrors() const { return _errors; }
+};
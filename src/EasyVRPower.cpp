@@ -0,0 +1,121 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#include "Arduino.h"
+#include "EasyVRPower.h"
+
+/*****************************************************************************/
+
+EasyVRPower::EasyVRPower(EasyVR& vr) : _vr(vr), _mode(EasyVR::WAKE_ON_CHAR), _idle(0),
+  _group(-1), _wordset(-1), _asleep(false), _timeAsleep(0), _timeAwake(0), _wakeups(0)
+{
+  _since = _active = millis();
+}
+
+void EasyVRPower::begin(uint32_t idle, int8_t mode)
+{
+  _idle = idle;
+  _mode = mode;
+  _active = millis();
+}
+
+void EasyVRPower::account(unsigned long now)
+{
+  if (_asleep)
+    _timeAsleep += now - _since;
+  else
+    _timeAwake += now - _since;
+  _since = now;
+}
+
+void EasyVRPower::rearm()
+{
+  if (_group >= 0)
+    _vr.recognizeCommand(_group);
+  else if (_wordset >= 0)
+    _vr.recognizeWord(_wordset);
+}
+
+void EasyVRPower::resume(unsigned long since)
+{
+  account(millis());
+  _asleep = false;
+  rearm();
+  // listening again, the wake-up was detected at "since"
+  _timer.rearmed(since);
+  ++_wakeups;
+  _active = millis();
+}
+
+bool EasyVRPower::sleep()
+{
+  if (_asleep)
+    return true;
+  // remember the recognition in progress, if any
+  _group = -1;
+  _wordset = -1;
+  if (_vr.isRecognizing())
+  {
+    _group = _vr.getRecognitionGroup();
+    if (_group < 0)
+      _wordset = _vr.getRecognitionWordset();
+    _vr.stop();
+  }
+  if (!_vr.sleep(_mode))
+  {
+    rearm(); // still awake, keep listening
+    return false;
+  }
+  account(millis());
+  _asleep = true;
+  return true;
+}
+
+bool EasyVRPower::wake()
+{
+  if (!_asleep)
+    return true;
+  unsigned long since = micros();
+  if (!_vr.detect())
+    return false;
+  resume(since);
+  return true;
+}
+
+bool EasyVRPower::poll()
+{
+  unsigned long now = _timer.poll();
+  if (!_asleep)
+  {
+    if (_idle != 0 && millis() - _active >= _idle && !sleep())
+      _active = millis(); // back off, retry after another idle time
+    return false;
+  }
+  if (!_vr.hasFinished())
+    return false;
+  if (!_vr.isAwakened())
+    return false; // unexpected reply, still asleep
+  resume(now);
+  return true;
+}
+
+uint32_t EasyVRPower::getTimeAsleep()
+{
+  account(millis());
+  return _timeAsleep;
+}
+
+uint32_t EasyVRPower::getTimeAwake()
+{
+  account(millis());
+  return _timeAwake;
+}
@@ -0,0 +1,136 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "Arduino.h"
+#include "EasyVR.h"
+#include "internal/gaptimer.h"
+
+/*****************************************************************************/
+
+/**
+  Puts an %EasyVR module to sleep when idle and resumes recognition on wake.
+
+  After a configurable idle time (see #activity()) the module is put in
+  sleep mode. If a recognition was in progress (see
+  #EasyVR::isRecognizing()), it is interrupted and started again as soon as
+  the module wakes up, either on its own (whistle,
+  claps or loud sound, as selected by the #EasyVR::WakeMode) or because the
+  application calls #wake(). While the module is asleep, it must not be
+  used by other parts of the application (check #isAwake()).
+
+  The time spent awake and asleep is accounted, together with the latency
+  between the wake-up event and the restart of recognition.
+*/
+class EasyVRPower
+{
+protected:
+  EasyVR& _vr;
+  int8_t _mode;             // wake mode
+  uint32_t _idle;           // idle time before sleeping (0 = never)
+  int8_t _group;            // recognition to restart (-1 = none)
+  int8_t _wordset;
+  bool _asleep;
+  unsigned long _since;     // time of last state change (in ms)
+  unsigned long _active;    // time of last activity (in ms)
+  uint32_t _timeAsleep;     // accumulated time asleep (in ms)
+  uint32_t _timeAwake;      // accumulated time awake (in ms)
+  EasyVRGapTimer _timer;    // wake latency and poll timing
+  uint16_t _wakeups;
+
+  void account(unsigned long now);
+  void rearm();
+  void resume(unsigned long since);
+
+public:
+  /**
+    Creates a power manager.
+    @param vr is the %EasyVR object to use
+  */
+  EasyVRPower(EasyVR& vr);
+  /**
+    Enables automatic sleep.
+    @param idle is the time in milliseconds without activity before the
+    module is put in sleep mode, or (0) to disable automatic sleep
+    @param mode is one of values in #EasyVR::WakeMode, optionally combined
+    with one of the values in #EasyVR::ClapSense
+  */
+  void begin(uint32_t idle, int8_t mode = EasyVR::WAKE_ON_CHAR);
+  /**
+    Restarts the idle timer. Call it whenever the module is used, for
+    example when a recognition result is received.
+  */
+  void activity() { _active = millis(); }
+  /**
+    Puts the module to sleep after the idle time, and checks for the wake-up
+    event while it is asleep, without waiting. It must be called often,
+    ideally from the main loop. If the module cannot be put to sleep, it
+    tries again after another idle time.
+    @retval true if the module has just woken up
+  */
+  bool poll();
+  /**
+    Puts the module to sleep now. A recognition in progress is interrupted,
+    and restarted if the module refuses to sleep.
+    @retval true if the operation is successful
+  */
+  bool sleep();
+  /**
+    Wakes up the module and restarts the interrupted recognition, if any.
+    @retval true if the module is awake
+  */
+  bool wake();
+  /**
+    Tells if the module is awake (and it can be used).
+    @retval true if awake
+  */
+  bool isAwake() const { return !_asleep; }
+  /**
+    Gets the total time spent in sleep mode.
+    @retval integer is the time in milliseconds
+  */
+  uint32_t getTimeAsleep();
+  /**
+    Gets the total time spent awake.
+    @retval integer is the time in milliseconds
+  */
+  uint32_t getTimeAwake();
+  /**
+    Gets the time from the detection of the last wake-up event, by #poll()
+    or #wake(), to the restart of recognition. The wake-up event may have
+    happened up to one poll interval earlier.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getWakeLatency() const { return _timer.gap(); }
+  /**
+    Gets the maximum of #getWakeLatency() since the power manager started.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getMaxWakeLatency() const { return _timer.maxGap(); }
+  /**
+    Gets the time between the last two calls to #poll(), that bounds how
+    late a wake-up event may be detected.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getPollInterval() const { return _timer.interval(); }
+  /**
+    Gets the maximum of #getPollInterval() since the power manager started.
+    @retval integer is the duration in microseconds
+  */
+  unsigned long getMaxPollInterval() const { return _timer.maxInterval(); }
+  /**
+    Gets the number of times the module has woken up.
+    @retval integer is the count of wake-up events
+  */
+  uint16_t getWakeups() const { return _wakeups; }
+};
@@ -0,0 +1,175 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#include "Arduino.h"
+#include "EasyVRSonicLink.h"
+
+/*****************************************************************************/
+
+EasyVRSonicLink::EasyVRSonicLink(EasyVR& vr) : _vr(vr), _txRepeat(0), _repeat(1),
+  _seq(0), _rxState(RX_IDLE), _rxHeader(0), _rxLen(0), _rxCount(0), _lastSeq(-1),
+  _frames(0), _repeats(0), _rxErrors(0), _txErrors(0)
+{
+}
+
+uint8_t EasyVRSonicLink::crc8(uint8_t crc, uint8_t data)
+{
+  // polynomial x^8 + x^2 + x + 1
+  crc ^= data;
+  for (int8_t i = 0; i < 8; ++i)
+    crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+  return crc;
+}
+
+void EasyVRSonicLink::sendNext()
+{
+  _vr.sendTokenAsync(8, _txPos < 0 ? (uint8_t)START : _tx[_txPos]);
+  _txTime = millis();
+  ++_txPos;
+}
+
+bool EasyVRSonicLink::send(const uint8_t* data, uint8_t len)
+{
+  if (_txRepeat > 0 || len > MAX_PAYLOAD)
+    return false;
+
+  uint8_t crc = 0;
+  _tx[0] = (_seq << 4) | len;
+  crc = crc8(crc, _tx[0]);
+  for (uint8_t i = 0; i < len; ++i)
+  {
+    _tx[i + 1] = data[i];
+    crc = crc8(crc, data[i]);
+  }
+  _tx[len + 1] = crc;
+  _txLen = len + 2;
+  _seq = (_seq + 1) & 0x0F;
+
+  _txRepeat = _repeat;
+  _txPos = -1;
+  sendNext();
+  return true;
+}
+
+bool EasyVRSonicLink::poll()
+{
+  if (_txRepeat == 0)
+    return false;
+
+  bool finished = _vr.hasFinished();
+  if (!finished && millis() - _txTime <= _vr.getReplyTimeout(EasyVR::TIMEOUT_TOKEN))
+    return false;
+
+  if (!finished || _vr.getError() >= 0 || _vr.isInvalid())
+  {
+    _txRepeat = 0;
+    ++_txErrors;
+    return true;
+  }
+  if (_txPos == _txLen)
+  {
+    if (--_txRepeat == 0)
+      return true;
+    _txPos = -1;
+  }
+  sendNext();
+  return false;
+}
+
+bool EasyVRSonicLink::write(const uint8_t* data, uint8_t len)
+{
+  uint16_t errors = _txErrors;
+  if (!send(data, len))
+    return false;
+  while (!poll())
+    ;
+  return _txErrors == errors;
+}
+
+void EasyVRSonicLink::skip(uint8_t n)
+{
+  // drop n tokens, then anything before the next start marker
+  while (n < _rxCount && _rxBuf[n] != START)
+    ++n;
+  if (n >= _rxCount)
+  {
+    _rxState = RX_IDLE;
+    _rxCount = 0;
+    return;
+  }
+  ++n; // the start marker itself
+  _rxCount -= n;
+  memmove(_rxBuf, _rxBuf + n, _rxCount);
+}
+
+bool EasyVRSonicLink::parse()
+{
+  while (_rxCount > 0)
+  {
+    uint8_t n = (_rxBuf[0] & 0x0F) + 2; // header, data and check
+    if (_rxCount < n)
+      return false;
+
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < n - 1; ++i)
+      crc = crc8(crc, _rxBuf[i]);
+    if (crc != _rxBuf[n - 1])
+    {
+      // wrong start, try again from the next marker in the frame
+      ++_rxErrors;
+      skip(1);
+      continue;
+    }
+    uint8_t header = _rxBuf[0];
+    if ((int8_t)(header >> 4) == _lastSeq)
+    {
+      ++_repeats;
+      skip(n);
+      continue;
+    }
+    _rxHeader = header;
+    _rxLen = header & 0x0F;
+    memcpy(_rx, _rxBuf + 1, _rxLen);
+    _lastSeq = header >> 4;
+    ++_frames;
+    skip(n);
+    return true;
+  }
+  return false;
+}
+
+bool EasyVRSonicLink::receive(const EasyVRResult& r)
+{
+  if (r.event != EasyVRDispatcher::ON_TOKEN)
+    return false;
+
+  uint8_t token = r.value;
+  if (_rxState != RX_IDLE && r.time - _rxTime > RX_TIMEOUT)
+  {
+    // frame interrupted, look for a new one
+    _rxState = RX_IDLE;
+    ++_rxErrors;
+  }
+  _rxTime = r.time;
+
+  if (_rxState == RX_IDLE)
+  {
+    if (token == START)
+    {
+      _rxState = RX_FRAME;
+      _rxCount = 0;
+    }
+    return false;
+  }
+  _rxBuf[_rxCount++] = token;
+  return parse();
+}
@@ -0,0 +1,159 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "EasyVRDispatcher.h"
+
+/*****************************************************************************/
+
+/**
+  Sends and receives small payloads as frames of 8-bit SonicNet tokens.
+
+  Each frame is made of a start marker (#START), a header with a sequence
+  number in the high nibble and the payload length in the low nibble, up to
+  #MAX_PAYLOAD bytes of data and a CRC-8 of the header and data. Since there
+  is no return channel, a frame can be sent more than once (see #setRepeat())
+  and the receiver delivers only the first copy with a given sequence number.
+
+  Frames are transmitted in the background with #send() and #poll(), one
+  token after the other, or with the blocking #write(). Received tokens are
+  fed to #receive(), usually from an #EasyVRTokenReceiver started with 8-bit
+  tokens and with duplicate suppression disabled (see
+  #EasyVRTokenReceiver::setWindow()). The tokens of the current frame are
+  kept until it is complete, so that when a token is lost or corrupted the
+  decoder can look for the next start marker among them (i.e. the start of
+  the next copy) instead of discarding it.
+*/
+class EasyVRSonicLink
+{
+public:
+  enum
+  {
+    START = 0xA5,       /**< Start of frame marker */
+    MAX_PAYLOAD = 15,   /**< Maximum length of the payload in bytes */
+    RX_TIMEOUT = 2000,  /**< Longest pause within a frame in milliseconds */
+  };
+
+protected:
+  enum { RX_IDLE, RX_FRAME };
+
+  EasyVR& _vr;
+  uint8_t _tx[MAX_PAYLOAD + 3];   // frame being transmitted, without marker
+  uint8_t _txLen;
+  int8_t _txPos;                  // next token to send (-1 = start marker)
+  uint8_t _txRepeat;              // copies left to send (0 = idle)
+  uint8_t _repeat;
+  uint8_t _seq;
+  unsigned long _txTime;          // time the current token was sent
+  uint8_t _rx[MAX_PAYLOAD];
+  uint8_t _rxState;
+  uint8_t _rxHeader;
+  uint8_t _rxLen;
+  uint8_t _rxBuf[MAX_PAYLOAD + 2]; // tokens after the start marker
+  uint8_t _rxCount;
+  int8_t _lastSeq;                // last delivered sequence (-1 = none)
+  unsigned long _rxTime;          // time of last token
+  uint16_t _frames;
+  uint16_t _repeats;
+  uint16_t _rxErrors;
+  uint16_t _txErrors;
+
+  static uint8_t crc8(uint8_t crc, uint8_t data);
+  void sendNext();
+  void skip(uint8_t n);
+  bool parse();
+
+public:
+  /**
+    Creates a SonicNet link.
+    @param vr is the %EasyVR object used for transmission
+  */
+  EasyVRSonicLink(EasyVR& vr);
+  /**
+    Sets how many times each frame is transmitted.
+    @param count (1-255) is the number of copies of each frame
+  */
+  void setRepeat(uint8_t count) { _repeat = count > 0 ? count : 1; }
+  /**
+    Starts transmission of a frame. Check for completion with #poll().
+    @param data points to the payload
+    @param len (0-15) is the length of the payload
+    @retval true if the frame has been accepted, false if a transmission is
+    already in progress or the payload is too long
+  */
+  bool send(const uint8_t* data, uint8_t len);
+  /**
+    Transmits the next token of the current frame when the previous one has
+    been played. It must be called often, ideally from the main loop.
+    Transmission is aborted if the module does not report completion of a
+    token within the #EasyVR::TIMEOUT_TOKEN reply timeout.
+    @retval true if the frame has been completely sent (or aborted)
+  */
+  bool poll();
+  /**
+    Tells if a frame is being transmitted.
+    @retval true if transmission is in progress
+  */
+  bool isSending() const { return _txRepeat > 0; }
+  /**
+    Transmits a frame and waits for completion (see #poll()).
+    @param data points to the payload
+    @param len (0-15) is the length of the payload
+    @retval true if the operation is successful
+  */
+  bool write(const uint8_t* data, uint8_t len);
+  /**
+    Feeds a received token to the frame decoder.
+    @param r is the result of a token detection (as read from
+    #EasyVRTokenReceiver::read() or decoded by #EasyVRDispatcher::decode())
+    @retval true if a new frame has been received
+  */
+  bool receive(const EasyVRResult& r);
+  /**
+    Gets the payload of the last received frame, valid until the next
+    token is fed to #receive().
+    @retval pointer to the payload data
+  */
+  const uint8_t* getData() const { return _rx; }
+  /**
+    Gets the length of the last received frame.
+    @retval integer is the payload length in bytes
+  */
+  uint8_t getLength() const { return _rxLen; }
+  /**
+    Gets the sequence number of the last received frame.
+    @retval (0-15) is the sequence number
+  */
+  uint8_t getSequence() const { return _rxHeader >> 4; }
+  /**
+    Gets the number of frames received.
+    @retval integer is the count of delivered frames
+  */
+  uint16_t getFrames() const { return _frames; }
+  /**
+    Gets the number of repeated frames that have been discarded.
+    @retval integer is the count of repeated frames
+  */
+  uint16_t getRepeats() const { return _repeats; }
+  /**
+    Gets the number of frames received with errors (bad checksum or length,
+    missing tokens).
+    @retval integer is the count of invalid frames
+  */
+  uint16_t getReceiveErrors() const { return _rxErrors; }
+  /**
+    Gets the number of frames whose transmission failed.
+    @retval integer is the count of aborted frames
+  */
+  uint16_t getSendErrors() const { return _txErrors; }
+};
@@ -0,0 +1,92 @@
+/*
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#include "Arduino.h"
+#include "EasyVRSoundIndex.h"
+
+/*****************************************************************************/
+
+uint16_t EasyVRSoundIndex::read(uint16_t offset) const
+{
+  const uint8_t* p = _data + offset;
+  if (_progmem)
+    return pgm_read_byte(p) | (pgm_read_byte(p + 1) << 8);
+  return p[0] | (p[1] << 8);
+}
+
+void EasyVRSoundIndex::begin(const char* name, int16_t count, const EasyVRSoundEntry* entries,
+  uint16_t size, bool progmem)
+{
+  // entries are read byte by byte, as little endian values
+  _name = name;
+  _nameLen = strlen(name);
+  _count = count;
+  _data = (const uint8_t*)entries;
+  _size = size;
+  _progmem = progmem;
+}
+
+bool EasyVRSoundIndex::begin(const uint8_t* blob, uint16_t length)
+{
+  _size = 0;
+  _progmem = false;
+  if (length < 8 || blob[0] != 'S' || blob[1] != 'X' || blob[2] != 1)
+    return false;
+  uint8_t len = blob[3];
+  if (length < 8U + len)
+    return false;
+  const uint8_t* p = blob + 4 + len;
+  uint16_t size = p[2] | (p[3] << 8);
+  if (length < 8U + len + size * 4U)
+    return false;
+
+  _name = (const char*)blob + 4;
+  _nameLen = len;
+  _count = p[0] | (p[1] << 8);
+  _data = p + 4;
+  _size = size;
+  return true;
+}
+
+bool EasyVRSoundIndex::verify(EasyVR& vr)
+{
+  for (uint16_t i = 0; i < _size; ++i)
+  {
+    if (i > 0 && hashAt(i) <= hashAt(i - 1))
+      return false; // not sorted, or not unique
+    if (indexAt(i) < 0 || indexAt(i) > _count)
+      return false;
+  }
+  char name[32];
+  int16_t count;
+  if (!vr.dumpSoundTable(name, count, sizeof(name)))
+    return false;
+  return count == _count && strlen(name) == _nameLen
+    && strncasecmp(name, _name, _nameLen) == 0;
+}
+
+int16_t EasyVRSoundIndex::find(uint16_t h) const
+{
+  uint16_t lo = 0, hi = _size;
+  while (lo < hi)
+  {
+    uint16_t mid = (lo + hi) / 2;
+    uint16_t v = hashAt(mid);
+    if (v == h)
+      return indexAt(mid);
+    if (v < h)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return -1;
+}
@@ -0,0 +1,142 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "EasyVR.h"
+
+/*****************************************************************************/
+
+/**
+  An entry of a sound table index.
+*/
+struct EasyVRSoundEntry
+{
+  uint16_t hash;  /**< Hash of the sound name, see #EASYVR_SOUND() */
+  int16_t index;  /**< Index of the sound in the sound table */
+};
+
+/**
+  Computes the hash of a sound name at compile time (not case sensitive).
+  @param name is a string literal with the sound name
+*/
+#define EASYVR_SOUND(name)  (EasyVRSoundIndex::hash(name))
+
+/**
+  Maps sound names to sound table indexes.
+
+  The index can be defined in a generated header, as an array of entries
+  (sorted by hash) possibly stored in flash memory with PROGMEM, or loaded
+  from a binary blob. Both can be produced from the list of sound names by
+  the SoundIndexGen tool, in extras/linux/tools, that also rejects names
+  with the same hash. The blob has the following layout (16-bit values are
+  little endian):
+  - 2 bytes: the characters 'S' and 'X'
+  - 1 byte: format version (1)
+  - 1 byte: length L of the sound table name
+  - L bytes: sound table name (not terminated)
+  - 2 bytes: number of sounds in the sound table
+  - 2 bytes: number N of entries
+  - N * 4 bytes: entries, as hash and index, sorted by hash
+
+  Names are never compared at run time: a name is reduced to a 16-bit hash,
+  at compile time with #EASYVR_SOUND(), and looked up with a binary search.
+  For a constant index (not loaded from a blob), #lookup() can even find the
+  sound index at compile time. Hashes must be unique, as checked by #verify()
+  together with the name and size of the sound table in the module.
+*/
+class EasyVRSoundIndex
+{
+  const char* _name;      // sound table name
+  const uint8_t* _data;   // entries
+  uint16_t _size;         // number of entries
+  int16_t _count;         // number of sounds in the sound table
+  uint8_t _nameLen;
+  bool _progmem;          // entries are in program memory
+
+  static constexpr uint8_t upper(char c)
+  {
+    return c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c;
+  }
+  static constexpr uint16_t fold(uint32_t h)
+  {
+    return (uint16_t)(h ^ (h >> 16));
+  }
+  uint16_t read(uint16_t offset) const;
+  uint16_t hashAt(uint16_t i) const { return read(i * 4); }
+  int16_t indexAt(uint16_t i) const { return (int16_t)read(i * 4 + 2); }
+
+public:
+  /**
+    Computes the hash of a sound name (FNV-1a folded to 16 bits, not case
+    sensitive). It can be evaluated at compile time.
+    @param name is the sound name
+    @param h is the running hash (leave default)
+    @retval integer is the hash of the name
+  */
+  static constexpr uint16_t hash(const char* name, uint32_t h = 2166136261UL)
+  {
+    return *name != 0 ? hash(name + 1, (uint32_t)((h ^ upper(*name)) * 16777619UL)) : fold(h);
+  }
+  /**
+    Finds a sound in an array of entries. When the arguments are constant,
+    it can be evaluated at compile time.
+    @param entries is the array of entries (not in program memory)
+    @param size is the number of entries
+    @param h is the hash of the sound name, see #EASYVR_SOUND()
+    @retval integer is the sound index, (-1) if not found
+  */
+  static constexpr int16_t lookup(const EasyVRSoundEntry* entries, uint16_t size, uint16_t h)
+  {
+    return size == 0 ? -1 : entries->hash == h ? entries->index : lookup(entries + 1, size - 1, h);
+  }
+
+  EasyVRSoundIndex() : _name(NULL), _data(NULL), _size(0), _count(0),
+    _nameLen(0), _progmem(false) {}
+  /**
+    Uses an index defined in the application code.
+    @param name is the name of the sound table
+    @param count is the number of sounds in the sound table
+    @param entries is the array of entries sorted by hash, it must stay valid
+    while in use
+    @param size is the number of entries
+    @param progmem tells if the entries are stored in program memory (PROGMEM)
+  */
+  void begin(const char* name, int16_t count, const EasyVRSoundEntry* entries,
+    uint16_t size, bool progmem = false);
+  /**
+    Uses an index stored in a binary blob.
+    @param blob points to the blob data, it must stay valid while in use
+    @param length is the size of the blob in bytes
+    @retval true if the blob has a valid format
+  */
+  bool begin(const uint8_t* blob, uint16_t length);
+  /**
+    Checks that the index is consistent and that it matches the sound table
+    in the module, as reported by #EasyVR::dumpSoundTable().
+    @param vr is the %EasyVR object to query
+    @retval true if the index can be used
+  */
+  bool verify(EasyVR& vr);
+  /**
+    Finds a sound by name hash.
+    @param h is the hash of the sound name, see #EASYVR_SOUND()
+    @retval integer is the sound index, (-1) if not found
+  */
+  int16_t find(uint16_t h) const;
+  /**
+    Finds a sound by name (the hash is computed at run time).
+    @param name is the sound name
+    @retval integer is the sound index, (-1) if not found
+  */
+  int16_t find(const char* name) const { return find(hash(name)); }
+};
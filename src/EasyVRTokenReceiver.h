@@ -0,0 +1,194 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include "Arduino.h"
+#include "EasyVRDispatcher.h"
+
+/*****************************************************************************/
+
+/**
+  Continuous reception of SonicNet tokens.
+
+  Token detection is started again as soon as the previous one completes,
+  so that tokens arriving while the application is busy are not lost.
+  Received tokens are queued with the time of reception, and can be read
+  later with #read(), or passed to #EasyVRDispatcher::dispatch(). The same
+  token received again within a configurable window is considered a
+  retransmission and it is discarded.
+  @tparam N is the capacity of the token queue (a power of two up to 128)
+*/
+template <uint8_t N = 8>
+class EasyVRTokenReceiver
+{
+  EasyVR& _vr;
+  EasyVRRing<EasyVRResult, N> _queue;
+  int8_t _bits;           // token length (0 = stopped)
+  int8_t _rejection;
+  uint16_t _timeout;
+  uint16_t _window;       // duplicate suppression window (in ms)
+  int16_t _last;          // last token received (-1 = none)
+  unsigned long _lastTime;
+  unsigned long _start;   // time of start (in ms)
+  uint16_t _received;     // tokens accepted
+  uint16_t _duplicates;   // tokens discarded as retransmissions
+  uint8_t _dropped;       // tokens lost because the queue was full
+  uint16_t _timeouts;     // detections ended without a token
+  uint16_t _errors;       // detections ended with an error
+
+  void arm()
+  {
+    _vr.detectToken(_bits, _rejection, _timeout);
+  }
+
+public:
+  enum
+  {
+    DEF_WINDOW = 1000, /**< Default duplicate suppression window (in ms) */
+  };
+
+  /**
+    Creates a continuous token receiver.
+    @param vr is the %EasyVR object to use
+  */
+  EasyVRTokenReceiver(EasyVR& vr) : _vr(vr), _bits(0), _window(DEF_WINDOW) {}
+  /**
+    Sets the duplicate suppression window.
+    @param ms is the time in milliseconds within which the same token
+    is considered a retransmission, or (0) to keep all tokens
+  */
+  void setWindow(uint16_t ms) { _window = ms; }
+  /**
+    Starts continuous token detection.
+    @param bits (4 or 8) specifies the length of received tokens
+    @param rejection (0-2) specifies the noise rejection level,
+    it can be one of the values in #EasyVR::RejectionLevel
+    @param timeout (1-28090) is the maximum time in milliseconds of each
+    detection, or (0) to listen without time limits
+  */
+  void start(int8_t bits, int8_t rejection = EasyVR::REJECTION_AVG, uint16_t timeout = 0)
+  {
+    _bits = bits;
+    _rejection = rejection;
+    _timeout = timeout;
+    _last = -1;
+    _received = 0;
+    _duplicates = 0;
+    _dropped = 0;
+    _timeouts = 0;
+    _errors = 0;
+    _queue.clear();
+    arm();
+    _start = millis();
+  }
+  /**
+    Stops continuous token detection.
+    @retval true if the module is back to ready
+  */
+  bool stop()
+  {
+    _bits = 0;
+    return _vr.stop();
+  }
+  /**
+    Tells if continuous token detection is running.
+    @retval true if not stopped
+  */
+  bool isActive() const { return _bits != 0; }
+  /**
+    Checks for completion of the current detection, re-arms it and queues
+    the token. It must be called often, ideally from the main loop.
+    @retval true if a detection has completed
+  */
+  bool poll()
+  {
+    if (_bits == 0 || !_vr.hasFinished())
+      return false;
+
+    EasyVRResult r;
+    EasyVRDispatcher::decode(_vr, r);
+    if (r.event == EasyVRDispatcher::ON_INVALID)
+    {
+      _bits = 0;
+      return true;
+    }
+    arm();
+
+    if (r.event == EasyVRDispatcher::ON_TOKEN)
+    {
+      if (r.value == _last && r.time - _lastTime < _window)
+        ++_duplicates;
+      else if (!_queue.push(r))
+      {
+        if (_dropped < 255)
+          ++_dropped;
+      }
+      else
+        ++_received;
+      // a sequence of retransmissions is discarded as a whole
+      _last = r.value;
+      _lastTime = r.time;
+    }
+    else if (r.event == EasyVRDispatcher::ON_TIMEOUT)
+      ++_timeouts;
+    else
+      ++_errors;
+    return true;
+  }
+  /**
+    Gets the number of queued tokens.
+    @retval integer is the count of tokens that can be read
+  */
+  uint8_t available() const { return _queue.count(); }
+  /**
+    Removes the oldest token from the queue.
+    @param r is a variable that holds the token when the function returns,
+    with the time of reception (as returned by millis())
+    @retval true if a token was available
+  */
+  bool read(EasyVRResult& r) { return _queue.pop(r); }
+  /**
+    Gets the number of tokens accepted since detection started.
+    @retval integer is the count of queued tokens
+  */
+  uint16_t getReceived() const { return _received; }
+  /**
+    Gets the average receive rate since detection started.
+    @retval integer is the number of accepted tokens per minute
+  */
+  uint16_t getRate() const
+  {
+    unsigned long t = millis() - _start;
+    return t > 0 ? (uint16_t)(_received * 60000UL / t) : 0;
+  }
+  /**
+    Gets the number of tokens discarded as retransmissions.
+    @retval integer is the count of duplicate tokens
+  */
+  uint16_t getDuplicates() const { return _duplicates; }
+  /**
+    Gets the number of tokens that did not fit in the queue.
+    @retval integer is the count of lost tokens
+  */
+  uint8_t getDropped() const { return _dropped; }
+  /**
+    Gets the number of detections that timed out.
+    @retval integer is the count of timeouts
+  */
+  uint16_t getTimeouts() const { return _timeouts; }
+  /**
+    Gets the number of detections that ended with an error.
+    @retval integer is the count of errors
+  */
+  uint16_t getErrors() const { return _errors; }
+};
@@ -0,0 +1,131 @@
+/** @file
+EasyVR library v1.11.1
+Copyright (C) 2019 RoboTech srl
+
+Written for Arduino and compatible boards for use with EasyVR modules or
+EasyVR Shield boards produced by RoboTech srl with the Fortebit <fortebit.tech>
+brand (formerly VeeaR <www.veear.eu>)
+
+Released under the terms of the MIT license, as found in the accompanying
+file COPYING.txt or at this address: <http://www.opensource.org/licenses/MIT>
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "internal/ring.h"
+
+/*****************************************************************************/
+
+/**
+  An asynchronous communication interface for the %EasyVR module.
+
+  When an %EasyVR object is created with a transport instead of a #Stream,
+  each command frame is queued with #write() and handed over at once with
+  #commit(), then the library returns to the caller without waiting for
+  the bytes to go out on the wire. Replies are collected with #available()
+  and #read() as with a #Stream.
+
+  The module needs some idle time between received characters (at least
+  1 ms, longer after selecting a new group), so each queued byte carries
+  the minimum pause that must follow it. The transmit engine (usually an
+  interrupt or a DMA channel triggered by a timer) is responsible for
+  honouring these pauses.
+*/
+class EasyVRTransport
+{
+public:
+  virtual ~EasyVRTransport() {}
+  /**
+    Gets the number of received bytes ready to be read.
+    @retval integer is the count of bytes in the receive buffer
+  */
+  virtual int available() = 0;
+  /**
+    Reads one received byte.
+    @retval integer is the byte value, (-1) if no data is available
+  */
+  virtual int read() = 0;
+  /**
+    Queues one byte of the current command frame.
+    @param c is the byte to transmit
+    @param hold (0-255) is the minimum idle time in milliseconds that must
+    follow this byte, before the next one is transmitted
+    @note It should only wait when the transmit queue is full.
+  */
+  virtual void write(uint8_t c, uint8_t hold) = 0;
+  /**
+    Marks the end of a command frame and starts transmission of the queued
+    bytes, if not already in progress. It must return immediately.
+  */
+  virtual void commit() = 0;
+  /**
+    Tells if previously committed bytes are still waiting to be transmitted.
+    @retval true if transmission is in progress
+  */
+  virtual bool sending() = 0;
+  /**
+    Waits until a byte is received or the given time has elapsed, so that
+    the caller can check again for a reply. It is used while waiting for
+    replies and it may return earlier. The default implementation returns
+    at once, as when busy waiting.
+    @param ms is the maximum time to wait in milliseconds
+  */
+  virtual void wait(uint16_t ms) { (void)ms; }
+};
+
+/**
+  A base for interrupt or DMA driven transports, with a transmit ring buffer.
+
+  Derived classes implement #start() to enable the transmit engine and,
+  from the engine context, call #next() to fetch each byte to send and
+  the idle time that must follow it. When #next() returns false the queue
+  is empty and the engine can stop until #start() is called again.
+  @tparam N is the capacity of the transmit queue (a power of two up to 128)
+*/
+template <uint8_t N>
+class EasyVRQueuedTransport : public EasyVRTransport
+{
+protected:
+  EasyVRRing<uint16_t, N> _tx; // byte in low part, hold time in high part
+
+  /**
+    Enables the transmit engine. It is called with a non-empty queue, even
+    if the engine is already running, so it must be safe to call again
+    (as it is, for example, enabling the "data register empty" interrupt).
+  */
+  virtual void start() = 0;
+  /**
+    Fetches the next byte to transmit (to be called by the transmit engine).
+    @param c is a variable that holds the byte to send
+    @param hold is a variable that holds the idle time in milliseconds that
+    must follow the byte
+    @retval true if a byte has been fetched, false if the queue is empty
+  */
+  bool next(uint8_t& c, uint8_t& hold)
+  {
+    uint16_t v;
+    if (!_tx.pop(v))
+      return false;
+    c = v & 0xFF;
+    hold = v >> 8;
+    return true;
+  }
+
+public:
+  void write(uint8_t c, uint8_t hold)
+  {
+    uint16_t v = c | ((uint16_t)hold << 8);
+    while (!_tx.push(v))
+      start(); // queue full, wait for the engine to make room
+  }
+  void commit()
+  {
+    if (!_tx.empty())
+      start();
+  }
+  bool sending()
+  {
+    return !_tx.empty();
+  }
+};
@@ -0,0 +1,62 @@
+#ifndef GAPTIMER_H
+#define GAPTIMER_H
+
+#include "Arduino.h"
+
+// Timing of a poll loop that re-arms the module after an operation completes
+// (recognition, playback, wake-up). Two durations are kept separately:
+// - the poll interval, time between two calls to poll(), that depends on the
+//   application and bounds how late a completion may be detected;
+// - the re-arm gap, time from the poll that detected the completion to the
+//   moment the module has been given the next operation, that only depends
+//   on the library and the link to the module.
+// The module may have been idle for at most the sum of the two.
+class EasyVRGapTimer
+{
+  unsigned long _poll;        // time of the current poll (in us)
+  unsigned long _interval;    // last time between polls (in us)
+  unsigned long _maxInterval;
+  unsigned long _gap;         // last re-arm gap (in us)
+  unsigned long _maxGap;
+
+public:
+  EasyVRGapTimer() { reset(); }
+
+  void reset()
+  {
+    _poll = micros();
+    _interval = 0;
+    _maxInterval = 0;
+    _gap = 0;
+    _maxGap = 0;
+  }
+
+  // call at the start of each poll, returns the time of the poll
+  unsigned long poll()
+  {
+    unsigned long now = micros();
+    _interval = now - _poll;
+    if (_interval > _maxInterval)
+      _maxInterval = _interval;
+    _poll = now;
+    return now;
+  }
+
+  // call after re-arming, when the completion was detected by this poll
+  void rearmed() { rearmed(_poll); }
+
+  // call after re-arming, when the completion was detected at "since"
+  void rearmed(unsigned long since)
+  {
+    _gap = micros() - since;
+    if (_gap > _maxGap)
+      _maxGap = _gap;
+  }
+
+  unsigned long interval() const { return _interval; }
+  unsigned long maxInterval() const { return _maxInterval; }
+  unsigned long gap() const { return _gap; }
+  unsigned long maxGap() const { return _maxGap; }
+};
+
+#endif //GAPTIMER_H
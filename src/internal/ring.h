@@ -0,0 +1,78 @@
+#ifndef RING_H
+#define RING_H
+
+#include <stdint.h>
+
+// compiler barrier: element stores must complete before the index is updated
+#define RING_BARRIER()  __asm__ __volatile__("" ::: "memory")
+
+// Fixed capacity FIFO of N elements (N must be a power of two, up to 128).
+// One producer and one consumer may run concurrently (i.e. main loop and
+// an interrupt handler) without locking, as long as each side only calls
+// its own functions: push() for the producer, pop()/peek()/drop() for the
+// consumer.
+template <typename T, uint8_t N>
+class EasyVRRing
+{
+  static_assert(N > 0 && N <= 128 && (N & (N - 1)) == 0,
+    "ring capacity must be a power of two up to 128");
+
+  T _buf[N];
+  volatile uint8_t _head; // next write position (producer)
+  volatile uint8_t _tail; // next read position (consumer)
+
+public:
+  EasyVRRing() : _head(0), _tail(0) {}
+
+  uint8_t count() const { return (uint8_t)(_head - _tail); }
+  uint8_t capacity() const { return N; }
+  bool empty() const { return _head == _tail; }
+  bool full() const { return count() >= N; }
+
+  bool push(const T& v)
+  {
+    uint8_t h = _head;
+    if ((uint8_t)(h - _tail) >= N)
+      return false;
+    _buf[h & (N - 1)] = v;
+    RING_BARRIER();
+    _head = h + 1;
+    return true;
+  }
+
+  bool pop(T& v)
+  {
+    uint8_t t = _tail;
+    if (t == _head)
+      return false;
+    v = _buf[t & (N - 1)];
+    RING_BARRIER();
+    _tail = t + 1;
+    return true;
+  }
+
+  // access the oldest element without removing it (NULL if empty)
+  T* peek()
+  {
+    return empty() ? 0 : &_buf[_tail & (N - 1)];
+  }
+
+  // access the i-th oldest element (no bounds check)
+  T& at(uint8_t i)
+  {
+    return _buf[(uint8_t)(_tail + i) & (N - 1)];
+  }
+
+  void drop()
+  {
+    if (!empty())
+      _tail = _tail + 1;
+  }
+
+  void clear()
+  {
+    _tail = _head;
+  }
+};
+
+#endif //RING_H